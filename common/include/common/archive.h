@@ -0,0 +1,83 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#ifndef ARCHIVE_H_
+#define ARCHIVE_H_
+
+#include <Windows.h>
+#include <filesystem>
+#include <vector>
+#include <span>
+
+#include "file_system.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+constexpr UINT32 kArchiveMagic = 0x4B505844; // "DXPK"
+constexpr UINT32 kArchiveVersion = 1;
+constexpr UINT64 kArchiveAlignment = 4096;
+constexpr UINT16 kArchiveEntryCompressed = 0x1;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct ArchiveHeader {
+    UINT32 magic;
+    UINT32 version;
+    UINT32 entry_count;
+    UINT32 names_size;
+    UINT64 toc_offset;
+    UINT64 names_offset;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct ArchiveEntry {
+    UINT64 hash;
+    UINT64 offset;
+    UINT64 size;
+    UINT64 stored_size;
+    UINT32 name_offset;
+    UINT16 name_size;
+    UINT16 flags;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class Archive final {
+public:
+    //! Constructor. Map an archive and validate its table of contents.
+    //! \param path The path of an archive.
+    explicit Archive(const std::filesystem::path &path);
+
+    //! Find an entry of a file.
+    //! \param path A relative file path.
+    //! \return An entry or nullptr if an archive doesn't have a file.
+    [[nodiscard]]
+    const ArchiveEntry *FindEntry(const std::filesystem::path &path) const;
+
+    //! Read the contents of an entry. A compressed entry is decompressed.
+    //! \param entry An entry.
+    //! \return The contents of an entry.
+    [[nodiscard]]
+    std::vector<BYTE> ReadEntry(const ArchiveEntry &entry) const;
+
+private:
+    MappedFile _file;
+    std::span<const ArchiveEntry> _entries;
+    const char *_names = nullptr;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Write an archive from files of directories. Entries are sorted by the hash of a path.
+//! \param path The path of an archive.
+//! \param directories Directories to pack. A file of the former directory wins when paths are duplicated.
+//! \param compress True if entries are compressed. An entry is stored as is if compression doesn't reduce the size.
+extern void WriteArchive(const std::filesystem::path &path, std::span<const std::filesystem::path> directories,
+                         bool compress);
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
@@ -7,6 +7,7 @@
 #define CAMERA_H_
 
 #include "utility.h"
+#include "culling.h"
 
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -45,6 +46,27 @@ public:
     //! \param radius The radius.
     void SetRadius(float radius);
 
+    //! Retrieve a position.
+    //! \return A position.
+    [[nodiscard]]
+    inline auto GetPosition() const {
+        return _position;
+    }
+
+    //! Retrieve the camera z near.
+    //! \return The z near.
+    [[nodiscard]]
+    inline auto GetNear() const {
+        return _near;
+    }
+
+    //! Retrieve the camera z far.
+    //! \return The z far.
+    [[nodiscard]]
+    inline auto GetFar() const {
+        return _far;
+    }
+
     //! Retrieve a forward vector.
     //! \return A forward vector.
     [[nodiscard]]
@@ -59,12 +81,10 @@ public:
         return _projection;
     }
 
-    //! Retrieve an inverse projection matrix.
+    //! Retrieve an inverse projection matrix. It is derived analytically from a perspective projection.
     //! \return An inverse projection matrix.
     [[nodiscard]]
-    inline auto GetInverseProjection() const {
-        return XMMatrixInverse(_projection);
-    }
+    const DirectX::XMFLOAT4X4 &GetInverseProjection() const;
 
     //! Retrieve a view matrix.
     //! \return A view matrix.
@@ -73,12 +93,30 @@ public:
         return _view;
     }
 
-    //! Retrieve an inverse view matrix.
+    //! Retrieve an inverse view matrix. It is derived analytically from a rigid view.
     //! \return An inverse view matrix.
     [[nodiscard]]
-    inline auto GetInverseView() const {
-        return XMMatrixInverse(_view);
-    }
+    const DirectX::XMFLOAT4X4 &GetInverseView() const;
+
+    //! Retrieve a view projection matrix.
+    //! \return A view projection matrix.
+    [[nodiscard]]
+    const DirectX::XMFLOAT4X4 &GetViewProjection() const;
+
+    //! Retrieve an inverse view projection matrix, which reconstructs a world position from a clip position.
+    //! \return An inverse view projection matrix.
+    [[nodiscard]]
+    const DirectX::XMFLOAT4X4 &GetInverseViewProjection() const;
+
+    //! Retrieve a normal matrix which transforms a normal from the world space to the view space.
+    //! \return A normal matrix.
+    [[nodiscard]]
+    const DirectX::XMFLOAT3X4 &GetViewNormal() const;
+
+    //! Retrieve a frustum in the world space. It is updated with a view matrix and a projection matrix.
+    //! \return A frustum.
+    [[nodiscard]]
+    const Frustum &GetFrustum() const;
 
 private:
     //! Update a position.
@@ -90,6 +128,10 @@ private:
     //! Update a view matrix.
     void UpdateView();
 
+    //! Update matrices and a frustum which are derived from a view matrix or a projection matrix.
+    //! They are updated on demand, so changing a camera several times in a frame updates them once.
+    void UpdateDerived() const;
+
 private:
     CameraMode _mode = CameraMode::kArcball;
     float _fov = DirectX::XMConvertToRadians(60.0f);
@@ -104,6 +146,13 @@ private:
     DirectX::XMFLOAT3 _forward = kZeroFloat3;
     DirectX::XMFLOAT4X4 _projection = kIdentityFloat4x4;
     DirectX::XMFLOAT4X4 _view = kIdentityFloat4x4;
+    mutable UINT _dirty = 0;
+    mutable DirectX::XMFLOAT4X4 _inverse_projection = kIdentityFloat4x4;
+    mutable DirectX::XMFLOAT4X4 _inverse_view = kIdentityFloat4x4;
+    mutable DirectX::XMFLOAT4X4 _view_projection = kIdentityFloat4x4;
+    mutable DirectX::XMFLOAT4X4 _inverse_view_projection = kIdentityFloat4x4;
+    mutable DirectX::XMFLOAT3X4 _view_normal = {};
+    mutable Frustum _frustum = {};
 };
 
 //----------------------------------------------------------------------------------------------------------------------
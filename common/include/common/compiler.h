@@ -9,7 +9,15 @@
 #include <wrl.h>
 #include <Windows.h>
 #include <dxcapi.h>
+#include <d3d12shader.h>
 #include <filesystem>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "include_handler.h"
+#include "shader_cache.h"
 
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -17,12 +25,41 @@ using Microsoft::WRL::ComPtr;
 
 //----------------------------------------------------------------------------------------------------------------------
 
+struct ShaderDefine {
+    std::wstring name;
+    std::wstring value;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct ShaderRequest {
+    std::filesystem::path path;
+    std::wstring entrypoint;
+    std::wstring target;
+    std::vector<ShaderDefine> defines;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct ShaderResult {
+    HRESULT result = E_FAIL;
+    UINT64 key = 0;
+    ComPtr<IDxcBlob> code;
+    std::string diagnostics;
+    std::vector<std::filesystem::path> dependencies;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
 class Compiler final {
 public:
-    //! Constructor.
+    //! Constructor. DLLs are loaded on the first compile which misses embedded shaders and the shader cache.
     Compiler();
 
-    //! Compile a shader
+    //! Compile a shader. A shader which was embedded at build time is returned first, and then a compiled shader
+    //! is cached on disk. A hit of either is returned without running the compiler.
+    //! Includes are resolved by the file system, and sources are cached in memory across compiles.
+    //! It must be called from one thread at a time.
     //! \param path The file path that contains the shader code.
     //! \param entrypoint The name of shader entrypoint function where shader execution begin.
     //! \param target The shader target or set of shader features to compile against.
@@ -31,6 +68,19 @@ public:
     HRESULT CompileShader(const std::filesystem::path &path, const std::wstring &entrypoint,
                           const std::wstring &target, IDxcBlob** code);
 
+    //! Compile shaders concurrently. Each worker thread compiles with its own compiler instance,
+    //! so it can be called from multiple threads.
+    //! \param requests Shaders to compile.
+    //! \return Results in the same order as requests. Dependencies of a result are the source and every file
+    //! which it included, so a shader must be recompiled when any of them is modified.
+    std::vector<ShaderResult> CompileShaders(std::span<const ShaderRequest> requests);
+
+    //! Retrieve the reflection of a compiled shader. The compiler is loaded if a shader was served from the cache.
+    //! \param code A compiled shader.
+    //! \param reflection A pointer to a variable that receives a pointer to ID3D12ShaderReflection.
+    //! \return A result.
+    HRESULT ReflectShader(IDxcBlob *code, ID3D12ShaderReflection **reflection);
+
     //! Compile a library.
     //! \param path The file path that contains the shader code.
     //! \param code The shader target or set of shader features to compile against.
@@ -38,18 +88,38 @@ public:
     HRESULT CompileLibrary(const std::filesystem::path &path, IDxcBlob** code);
 
 private:
-    //! Initialize DLLs.
+    struct Instance {
+        ComPtr<IDxcCompiler> compiler;
+    };
+
+    //! Compile a shader with an instance. An instance is initialized on the first cache miss.
+    //! \param instance A compiler instance which is used by the calling thread only.
+    //! \param request A shader to compile.
+    //! \return A result.
+    ShaderResult Compile(Instance *instance, const ShaderRequest &request);
+
+    //! Build the cache key of a shader. A key covers the source and its includes, the entrypoint, the target,
+    //! defines, compile options and the version of the compiler.
+    //! \param request A shader to compile.
+    //! \return A key.
+    [[nodiscard]]
+    UINT64 BuildCacheKey(const ShaderRequest &request) const;
+
+    //! Initialize DLLs. DLLs are loaded once even if instances are initialized concurrently.
     void InitDLLs();
 
-    //! Initialize compiler and library.
-    void InitCompilerAndLibrary();
+    //! Initialize the compiler of an instance.
+    //! \param instance A compiler instance.
+    void InitInstance(Instance *instance);
 
 private:
     HMODULE _dxil = 0;
     HMODULE _dxcompiler = 0;
-    ComPtr<IDxcCompiler> _compiler;
-    ComPtr<IDxcLibrary> _library;
-    ComPtr<IDxcIncludeHandler> _include_handler;
+    std::once_flag _dll_flag;
+    Instance _instance;
+    IncludeCache _include_cache;
+    ShaderCache _shader_cache;
+    UINT64 _compiler_version = 0;
 };
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,29 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#ifndef COMPRESSION_H_
+#define COMPRESSION_H_
+
+#include <Windows.h>
+#include <vector>
+#include <span>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Compress data to the LZ4 block format. It is a greedy compressor which favours decompression speed.
+//! \param src Data to compress.
+//! \return Compressed data.
+extern std::vector<BYTE> CompressLZ4(std::span<const BYTE> src);
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Decompress data of the LZ4 block format.
+//! \param src Compressed data.
+//! \param dst A buffer which has exactly the size of decompressed data.
+extern void DecompressLZ4(std::span<const BYTE> src, std::span<BYTE> dst);
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
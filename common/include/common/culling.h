@@ -0,0 +1,111 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#ifndef CULLING_H_
+#define CULLING_H_
+
+#include <Windows.h>
+#include <DirectXMath.h>
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Frustum {
+    //! Planes in the order of left, right, bottom, top, near and far. A plane is (a, b, c, d) where
+    //! a * x + b * y + c * z + d >= 0 is inside, and (a, b, c) is normalized.
+    std::array<DirectX::XMFLOAT4, 6> planes;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Axis aligned bounding boxes in the structure of arrays layout.
+struct BoundingBoxes {
+    const float *center_x;
+    const float *center_y;
+    const float *center_z;
+    const float *extent_x;
+    const float *extent_y;
+    const float *extent_z;
+    size_t count;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Bounding spheres in the structure of arrays layout.
+struct BoundingSpheres {
+    const float *center_x;
+    const float *center_y;
+    const float *center_z;
+    const float *radius;
+    size_t count;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Test a box against a frustum. Terms are added in the same order as vectorized paths, so results are the same,
+//! and NaN is culled like a vectorized comparison.
+//! \param frustum A frustum.
+//! \param boxes Bounding boxes.
+//! \param i The index of a box.
+//! \return True if a box is visible.
+inline bool IsBoxVisible(const Frustum &frustum, const BoundingBoxes &boxes, size_t i) {
+    for (auto &plane : frustum.planes) {
+        auto distance = (plane.x * boxes.center_x[i] + plane.y * boxes.center_y[i]) +
+                        (plane.z * boxes.center_z[i] + plane.w);
+        auto radius = (fabsf(plane.x) * boxes.extent_x[i] + fabsf(plane.y) * boxes.extent_y[i]) +
+                      fabsf(plane.z) * boxes.extent_z[i];
+        if (!(distance + radius >= 0.0f)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Test a sphere against a frustum. NaN is culled like a vectorized comparison.
+//! \param frustum A frustum.
+//! \param spheres Bounding spheres.
+//! \param i The index of a sphere.
+//! \return True if a sphere is visible.
+inline bool IsSphereVisible(const Frustum &frustum, const BoundingSpheres &spheres, size_t i) {
+    for (auto &plane : frustum.planes) {
+        auto distance = (plane.x * spheres.center_x[i] + plane.y * spheres.center_y[i]) +
+                        (plane.z * spheres.center_z[i] + plane.w);
+        if (!(distance + spheres.radius[i] >= 0.0f)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Extract a frustum from a view projection matrix. Planes are in the space which a matrix transforms from.
+//! \param view_projection A view projection matrix, whose depth range is from 0 to 1.
+//! \return A frustum.
+extern Frustum ExtractFrustum(const DirectX::XMFLOAT4X4 &view_projection);
+
+//! Test bounding boxes against a frustum. A box is conservatively visible if it isn't outside of any plane.
+//! \param frustum A frustum.
+//! \param boxes Bounding boxes.
+//! \param mask A visibility mask which has (count + 7) / 8 bytes. Bit i % 8 of byte i / 8 is set if box i is
+//! visible, and unused bits of the last byte are cleared.
+extern void CullBoxes(const Frustum &frustum, const BoundingBoxes &boxes, BYTE *mask);
+
+//! Test bounding spheres against a frustum. A sphere is conservatively visible if it isn't outside of any plane.
+//! \param frustum A frustum.
+//! \param spheres Bounding spheres.
+//! \param mask A visibility mask which has (count + 7) / 8 bytes. Bit i % 8 of byte i / 8 is set if sphere i is
+//! visible, and unused bits of the last byte are cleared.
+extern void CullSpheres(const Frustum &frustum, const BoundingSpheres &spheres, BYTE *mask);
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
@@ -0,0 +1,35 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#ifndef EMBEDDED_SHADER_H_
+#define EMBEDDED_SHADER_H_
+
+#include <Windows.h>
+#include <span>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct EmbeddedShader {
+    UINT64 key;
+    const BYTE *code;
+    size_t size;
+    const char *dependencies; // UTF-8 paths which are terminated by '\0', and the list ends with an empty path.
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Register shaders which were compiled at build time. Generated sources call it at static initialization,
+//! so shaders are registered before the compiler is used.
+//! \param shaders Embedded shaders. They must outlive the program.
+extern void RegisterEmbeddedShaders(std::span<const EmbeddedShader> shaders);
+
+//! Find an embedded shader. It can be called from multiple threads.
+//! \param key The cache key of a shader.
+//! \return An embedded shader, or null if a shader isn't embedded.
+extern const EmbeddedShader *FindEmbeddedShader(UINT64 key);
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
@@ -13,6 +13,7 @@
 #include <DirectXColors.h>
 #include <string>
 #include <array>
+#include <memory>
 #include <unordered_map>
 
 #include "utility.h"
@@ -21,6 +22,9 @@
 #include "camera.h"
 #include "compiler.h"
 #include "file_system.h"
+#include "hot_reload.h"
+#include "pipeline_cache.h"
+#include "profiler.h"
 
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -125,6 +129,9 @@ protected:
     //! Initialize a device.
     void InitDevice();
 
+    //! Initialize a pipeline cache.
+    void InitPipelineCache();
+
     //! Initialize a command queue.
     void InitCommandQueue();
 
@@ -180,12 +187,14 @@ protected:
     UINT _fps = 0;
     Duration _fps_time = Duration::zero();
     Compiler _compiler;
+    HotReload _hot_reload;
     Camera _camera;
     POINT _mouse_position = {0, 0};
     ComPtr<IDXGIFactory7> _factory;
     ComPtr<IDXGIAdapter4> _adapter;
     DXGI_ADAPTER_DESC3 _adapter_desc;
     ComPtr<ID3D12Device5> _device;
+    std::unique_ptr<PipelineCache> _pipeline_cache;
     ComPtr<ID3D12CommandQueue> _command_queue;
     FrameResource<ID3D12CommandAllocator> _command_allocators;
     ComPtr<ID3D12GraphicsCommandList4> _command_list;
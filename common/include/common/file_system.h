@@ -9,7 +9,50 @@
 #include <Windows.h>
 #include <filesystem>
 #include <vector>
-#include <set>
+#include <span>
+#include <future>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class MappedFile final {
+public:
+    //! Constructor. Map a whole file to memory as read only.
+    //! \param path A file path.
+    explicit MappedFile(const std::filesystem::path &path);
+
+    //! Move constructor.
+    //! \param other A mapped file to move from.
+    MappedFile(MappedFile &&other) noexcept;
+
+    //! Destructor. Unmap a file.
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    MappedFile &operator=(MappedFile &&) = delete;
+
+    //! Retrieve the contents of a file. Pages are loaded on first access.
+    //! \return The contents of a file.
+    [[nodiscard]]
+    inline std::span<const BYTE> GetData() const {
+        return {_data, _size};
+    }
+
+private:
+    HANDLE _file = INVALID_HANDLE_VALUE;
+    HANDLE _mapping = nullptr;
+    const BYTE *_data = nullptr;
+    size_t _size = 0;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class Archive;
 
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -20,18 +63,58 @@ public:
     [[nodiscard]]
     static FileSystem* GetInstance();
 
-    //! Read a file.
+    //! Read a file. Mounted archives are searched before directories.
+    //! The contents are read at once into a buffer which is allocated by the size of a file.
     //! \param path A file path.
     //! \return The contents of a file.
     [[nodiscard]]
     std::vector<BYTE> ReadFile(const std::filesystem::path &path) const;
 
-    //! Add a directory to find a file.
+    //! Read a file on an I/O worker thread. Many reads can be in flight, and each read is served like ReadFile.
+    //! \param path A file path.
+    //! \return A future that receives the contents of a file.
+    [[nodiscard]]
+    std::future<std::vector<BYTE>> ReadFileAsync(const std::filesystem::path &path) const;
+
+    //! Map a file to memory. It avoids a copy of the contents when a file is only read. Archives aren't searched.
+    //! \param path A file path.
+    //! \return A mapped file.
+    [[nodiscard]]
+    MappedFile MapFile(const std::filesystem::path &path) const;
+
+    //! Add a directory to find a file. A directory of the higher priority is searched first,
+    //! and directories of the same priority are searched in the order they were added.
     //! \param directory A directory to find a file.
-    void AddDirectory(const std::filesystem::path &directory);
+    //! \param priority The priority of a directory.
+    void AddDirectory(const std::filesystem::path &directory, INT priority = 0);
+
+    //! Find a file in directories. A resolved path is cached until a directory is added.
+    //! \param path A file path.
+    //! \return The path of an existing file.
+    [[nodiscard]]
+    std::filesystem::path FindFile(const std::filesystem::path &path) const;
+
+    //! Retrieve directories in the search order.
+    //! \return Directories.
+    [[nodiscard]]
+    std::vector<std::filesystem::path> GetDirectories() const;
+
+    //! Mount an archive. Archives are searched in the order they were mounted.
+    //! \param path The path of an archive.
+    void MountArchive(const std::filesystem::path &path);
+
+private:
+    struct Directory {
+        std::filesystem::path path;
+        INT priority;
+    };
 
 private:
-    std::set<std::filesystem::path> _directories = {COMMON_ASSET_DIR};
+    std::vector<Directory> _directories = {{COMMON_ASSET_DIR, 0}};
+    std::vector<std::unique_ptr<Archive>> _archives;
+    mutable std::unordered_map<std::filesystem::path::string_type, std::filesystem::path> _resolved_paths;
+    mutable std::shared_mutex _mutex;
+    UINT64 _generation = 0;
 };
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,67 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#ifndef FILE_WATCHER_H_
+#define FILE_WATCHER_H_
+
+#include <Windows.h>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class FileWatcher final {
+public:
+    //! Constructor. Start watching directories and their subdirectories on a worker thread.
+    //! \param directories Directories to watch. A directory which doesn't exist is ignored.
+    explicit FileWatcher(std::span<const std::filesystem::path> directories);
+
+    //! Destructor. Stop watching directories.
+    ~FileWatcher();
+
+    //! Retrieve changed files. A file is reported once it isn't changed for the quiet time,
+    //! so a burst of changes by a single save is reported as one change. When changes are lost because the buffer
+    //! of a directory overflowed, the watched directory itself is reported, so every file under it may be changed.
+    //! \param quiet_time The time which a file must be quiet for.
+    //! \return Changed files and overflowed directories.
+    std::vector<std::filesystem::path> Poll(std::chrono::milliseconds quiet_time);
+
+private:
+    struct Directory {
+        std::filesystem::path path;
+        HANDLE handle = INVALID_HANDLE_VALUE;
+        OVERLAPPED overlapped = {};
+        std::vector<DWORD> buffer;
+    };
+
+    struct Change {
+        std::filesystem::path path;
+        std::chrono::steady_clock::time_point time;
+    };
+
+    //! Wait for changes until a watcher is destroyed.
+    void Run();
+
+    //! Issue a request to read changes of a directory.
+    //! \param directory A directory.
+    void ReadChanges(Directory *directory);
+
+private:
+    std::vector<std::unique_ptr<Directory>> _directories;
+    HANDLE _stop_event = nullptr;
+    std::thread _thread;
+    std::mutex _mutex;
+    std::unordered_map<std::filesystem::path::string_type, Change> _changes;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
@@ -0,0 +1,83 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#ifndef HOT_RELOAD_H_
+#define HOT_RELOAD_H_
+
+#include <Windows.h>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "file_watcher.h"
+#include "thread_pool.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class HotReload final {
+public:
+    //! A function which installs a rebuilt object. It is called at a frame boundary.
+    using Swap = std::function<void()>;
+
+    //! A function which rebuilds an object on a worker thread. It must not touch objects in use by a frame.
+    using Rebuild = std::function<Swap()>;
+
+    //! Destructor. Stop watching and wait for rebuilds in flight.
+    ~HotReload();
+
+    //! Register a dependent which is rebuilt when any of its files is changed.
+    //! \param dependencies Files which a dependent is built from. They are resolved by the file system.
+    //! \param rebuild A function which rebuilds a dependent.
+    //! \return The index of a dependent.
+    UINT Register(const std::vector<std::filesystem::path> &dependencies, Rebuild rebuild);
+
+    //! Replace the files of a dependent. A shader passes the dependencies of its last compile, so includes which
+    //! are added or removed by an edit are followed. It can be called from a swap.
+    //! \param dependent The index of a dependent.
+    //! \param dependencies Files which a dependent is built from. They are resolved by the file system.
+    void SetDependencies(UINT dependent, const std::vector<std::filesystem::path> &dependencies);
+
+    //! Mark dependents of a changed file dirty. A directory marks dependents of every file under it, which is how
+    //! a watcher reports changes that were lost. Dirty dependents are rebuilt by the next update.
+    //! \param path The resolved path of a file or a directory.
+    void Invalidate(const std::filesystem::path &path);
+
+    //! Start watching directories.
+    //! \param directories Directories to watch.
+    void Start(std::span<const std::filesystem::path> directories);
+
+    //! Stop watching and wait for rebuilds in flight. Rebuilt objects are discarded.
+    void Stop();
+
+    //! Dispatch rebuilds of dependents whose files are changed and collect completed rebuilds.
+    //! \return True if there are rebuilt objects to swap.
+    bool Update();
+
+    //! Swap rebuilt objects. Objects which are replaced may still be used by the GPU,
+    //! so a caller must wait until the GPU is idle.
+    void Apply();
+
+private:
+    struct Dependent {
+        Rebuild rebuild;
+        std::future<Swap> future;
+        bool dirty = false;
+    };
+
+private:
+    std::vector<Dependent> _dependents;
+    std::unordered_map<std::filesystem::path::string_type, std::vector<UINT>> _file_dependents;
+    std::unique_ptr<FileWatcher> _file_watcher;
+    std::unique_ptr<ThreadPool> _thread_pool;
+    std::vector<Swap> _swaps;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
@@ -10,6 +10,8 @@
 #include <dxgiformat.h>
 #include <vector>
 #include <filesystem>
+#include <future>
+#include <span>
 
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -28,6 +30,7 @@ struct Image {
     UINT16 array_size = 0;
     UINT16 mip_levels = 0;
     DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+    bool cube = false;
     std::vector<Subresource> subresources;
 };
 
@@ -39,6 +42,42 @@ public:
     //! \param path A file path.
     //! \return An image.
     Image LoadFile(const std::filesystem::path &path);
+
+    //! Load an image from file on a shared pool of worker threads. Formats are copied when a load starts, so a loader
+    //! doesn't need to outlive a future and later settings don't affect it. The file system must outlive a future.
+    //! \param path A file path.
+    //! \return A future that receives an image.
+    std::future<Image> LoadFileAsync(const std::filesystem::path &path);
+
+    //! Load images from files concurrently. Files are read and decoded on a shared pool of worker threads, which
+    //! bounds the number of files in flight.
+    //! \param paths File paths.
+    //! \return Images in the same order as the file paths.
+    std::vector<Image> LoadFiles(std::span<const std::filesystem::path> paths);
+
+    //! Load images from files and assemble them into an array. A cube map contributes 6 slices.
+    //! \param paths File paths. All images must have the same size, format and mip levels.
+    //! \return An image whose slices are in the same order as the file paths.
+    Image LoadArray(std::span<const std::filesystem::path> paths);
+
+    //! Set the format of HDR images. The default is R16G16B16A16_FLOAT.
+    //! \param format R16G16B16A16_FLOAT or R11G11B10_FLOAT.
+    void SetHDRFormat(DXGI_FORMAT format);
+
+    //! Set the format of 8 bit images. The default is R8G8B8A8_UNORM. Pixels are converted while they are loaded:
+    //! B8G8R8A8 formats swap red and blue, and R16G16B16A16_FLOAT decodes sRGB colors to linear half floats.
+    //! \param format R8G8B8A8_UNORM, R8G8B8A8_UNORM_SRGB, B8G8R8A8_UNORM, B8G8R8A8_UNORM_SRGB or R16G16B16A16_FLOAT.
+    void SetLDRFormat(DXGI_FORMAT format);
+
+    //! Set whether colors of 8 bit images are multiplied by alpha while they are loaded. Colors are multiplied
+    //! before they are converted to the format of 8 bit images.
+    //! \param premultiplied True if colors are multiplied by alpha.
+    void SetPremultipliedAlpha(bool premultiplied);
+
+private:
+    DXGI_FORMAT _hdr_format = DXGI_FORMAT_R16G16B16A16_FLOAT;
+    DXGI_FORMAT _ldr_format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    bool _premultiplied = false;
 };
 
 //----------------------------------------------------------------------------------------------------------------------
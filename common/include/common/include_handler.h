@@ -0,0 +1,79 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#ifndef INCLUDE_HANDLER_H_
+#define INCLUDE_HANDLER_H_
+
+#include <wrl.h>
+#include <Windows.h>
+#include <dxcapi.h>
+#include <filesystem>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+using Microsoft::WRL::ComPtr;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class IncludeCache final {
+public:
+    //! Load a source through the file system. Contents are shared by compiles until the file is modified.
+    //! It can be called from multiple threads.
+    //! \param path A file path.
+    //! \return The contents of a file, or null if a file isn't exist.
+    std::shared_ptr<const std::vector<BYTE>> Load(const std::filesystem::path &path);
+
+private:
+    struct Entry {
+        std::filesystem::file_time_type time;
+        std::shared_ptr<const std::vector<BYTE>> contents;
+    };
+
+private:
+    std::shared_mutex _mutex;
+    std::unordered_map<std::filesystem::path::string_type, Entry> _entries;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class IncludeHandler final : public Microsoft::WRL::RuntimeClass<
+        Microsoft::WRL::RuntimeClassFlags<Microsoft::WRL::ClassicCom>, IDxcIncludeHandler> {
+public:
+    //! Constructor. A handler is created for each compile, so it records the dependencies of a shader.
+    //! \param cache A cache which is shared by handlers.
+    explicit IncludeHandler(IncludeCache *cache);
+
+    //! Load an include. A path is resolved relative to the including file and then searched by the file system.
+    //! \param filename A path of an include.
+    //! \param include_source A pointer to a variable that receives a pointer to IDxcBlob.
+    //! \return A result.
+    HRESULT STDMETHODCALLTYPE LoadSource(LPCWSTR filename, IDxcBlob **include_source) override;
+
+    //! Retrieve files which were included.
+    //! \return Normalized paths of includes in the order they were first loaded.
+    [[nodiscard]]
+    inline const auto &GetDependencies() const {
+        return _dependencies;
+    }
+
+private:
+    IncludeCache *_cache = nullptr;
+    std::vector<std::filesystem::path> _dependencies;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Create a UTF-8 blob which shares the contents of a source.
+//! \param contents The contents of a source.
+//! \return A blob.
+extern ComPtr<IDxcBlobEncoding> CreateSourceBlob(std::shared_ptr<const std::vector<BYTE>> contents);
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
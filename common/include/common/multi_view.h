@@ -0,0 +1,114 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#ifndef MULTI_VIEW_H_
+#define MULTI_VIEW_H_
+
+#include <Windows.h>
+#include <DirectXMath.h>
+#include <array>
+
+#include "camera.h"
+#include "culling.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+constexpr UINT kMaxViewCount = 6;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Constants of every view, which are laid out as a HLSL constant buffer. A single instanced pass renders
+//! all views by selecting a view with SV_ViewID or SV_InstanceID % view_count.
+struct MultiViewConstants {
+    std::array<DirectX::XMFLOAT4X4, kMaxViewCount> view_projections;
+    //! The xyz is the position of a view in the world space, and the w is the far depth of a view. The far depth
+    //! of a cascade is the split depth in the view space of a camera.
+    std::array<DirectX::XMFLOAT4, kMaxViewCount> positions;
+    UINT view_count;
+    UINT padding[3];
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class MultiView final {
+public:
+    //! Set views to six faces of a cube map in the order of +x, -x, +y, -y, +z and -z.
+    //! \param position The center of a cube map.
+    //! \param z_near The z near.
+    //! \param z_far The z far.
+    void SetCubeFaces(const DirectX::XMFLOAT3 &position, float z_near, float z_far);
+
+    //! Set views to shadow cascades which are fitted to the frustum of a camera. A depth range of a camera is split
+    //! by blending a logarithmic split and a uniform split. A cascade encloses the bounding sphere of a split,
+    //! so its extent doesn't change when a camera rotates. The depth range of a cascade starts caster_distance
+    //! before the sphere toward a light, so casters outside of a camera frustum still cast shadows into it.
+    //! \param camera A camera.
+    //! \param light_direction The direction of a light.
+    //! \param count The number of cascades. It must not exceed kMaxViewCount.
+    //! \param caster_distance The distance from a split to the farthest caster toward a light. A longer distance
+    //! lowers depth precision, and casters beyond it are clipped unless depths are clamped.
+    //! \param lambda The weight of a logarithmic split from 0 to 1.
+    void SetCascades(const Camera &camera, const DirectX::XMFLOAT3 &light_direction, UINT count,
+                     float caster_distance, float lambda = 0.5f);
+
+    //! Set views to a left eye and a right eye in this order. Eyes are offset along the right axis of a camera,
+    //! and they share the projection of a camera.
+    //! \param camera A camera.
+    //! \param eye_separation The distance between eyes.
+    void SetStereo(const Camera &camera, float eye_separation);
+
+    //! Retrieve the number of views.
+    //! \return The number of views.
+    [[nodiscard]]
+    inline auto GetViewCount() const {
+        return _constants.view_count;
+    }
+
+    //! Retrieve a view matrix.
+    //! \param index The index of a view.
+    //! \return A view matrix.
+    [[nodiscard]]
+    inline const auto &GetView(UINT index) const {
+        return _views[index];
+    }
+
+    //! Retrieve a projection matrix.
+    //! \param index The index of a view.
+    //! \return A projection matrix.
+    [[nodiscard]]
+    inline const auto &GetProjection(UINT index) const {
+        return _projections[index];
+    }
+
+    //! Retrieve a frustum in the world space.
+    //! \param index The index of a view.
+    //! \return A frustum.
+    [[nodiscard]]
+    inline const auto &GetFrustum(UINT index) const {
+        return _frustums[index];
+    }
+
+    //! Retrieve constants of every view, which are uploaded once per frame.
+    //! \return Constants.
+    [[nodiscard]]
+    inline const auto &GetConstants() const {
+        return _constants;
+    }
+
+private:
+    //! Update view projection matrices and frustums of every view in a single pass.
+    //! \param count The number of views.
+    void UpdateViews(UINT count);
+
+private:
+    std::array<DirectX::XMFLOAT4X4, kMaxViewCount> _views = {};
+    std::array<DirectX::XMFLOAT4X4, kMaxViewCount> _projections = {};
+    std::array<Frustum, kMaxViewCount> _frustums = {};
+    MultiViewConstants _constants = {};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
@@ -0,0 +1,100 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#ifndef PIPELINE_CACHE_H_
+#define PIPELINE_CACHE_H_
+
+#include <wrl.h>
+#include <d3d12.h>
+#include <filesystem>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "pipeline_hash.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+using Microsoft::WRL::ComPtr;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+constexpr UINT32 kRootSignatureCacheMagic = 0x53524458; // 'XDRS'
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct RootSignatureCacheHeader {
+    UINT32 magic;
+    UINT32 version;
+    UINT64 key;
+    UINT64 size;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Write a serialized root signature after a header. A cache is optional, so a failure is ignored.
+//! \param path A file path.
+//! \param key The key of a root signature.
+//! \param data A serialized root signature.
+extern void WriteRootSignatureFile(const std::filesystem::path &path, UINT64 key, std::span<const BYTE> data);
+
+//! Read a serialized root signature. A file which was written by another version or for another key is ignored.
+//! \param path A file path.
+//! \param key The key of a root signature.
+//! \return A serialized root signature, or empty if a file isn't valid.
+[[nodiscard]]
+extern std::vector<BYTE> ReadRootSignatureFile(const std::filesystem::path &path, UINT64 key);
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class PipelineCache final {
+public:
+    //! Constructor. A pipeline library which was saved by a previous run is loaded, and it is discarded if
+    //! it was saved by another driver or adapter.
+    //! \param device A device.
+    //! \param directory A directory where root signatures and a pipeline library are stored.
+    PipelineCache(ID3D12Device *device, const std::filesystem::path &directory);
+
+    //! Create a root signature. A serialized root signature is loaded from disk, or it is serialized and stored.
+    //! Root signatures of an equal description are shared. It can be called from multiple threads.
+    //! \param desc The description of a root signature.
+    //! \param root_signature A pointer to a variable that receives a pointer to ID3D12RootSignature.
+    //! \return A result.
+    HRESULT CreateRootSignature(const D3D12_ROOT_SIGNATURE_DESC &desc, ID3D12RootSignature **root_signature);
+
+    //! Create a graphics pipeline state. A pipeline state is loaded from the pipeline library, or it is created and
+    //! stored. A pipeline state whose root signature wasn't created by this cache isn't cached.
+    //! It can be called from multiple threads, for example by a rebuild of hot reload.
+    //! \param desc The description of a graphics pipeline state.
+    //! \param pipeline_state A pointer to a variable that receives a pointer to ID3D12PipelineState.
+    //! \return A result.
+    HRESULT CreateGraphicsPipelineState(const D3D12_GRAPHICS_PIPELINE_STATE_DESC &desc,
+                                        ID3D12PipelineState **pipeline_state);
+
+    //! Save the pipeline library if pipeline states were stored. It must not be called concurrently with creation.
+    void Save();
+
+private:
+    //! Build the file path of a root signature.
+    //! \param key The key of a root signature.
+    //! \return A file path.
+    [[nodiscard]]
+    std::filesystem::path BuildPath(UINT64 key) const;
+
+private:
+    ID3D12Device *_device = nullptr;
+    std::filesystem::path _directory;
+    std::mutex _mutex;
+    std::vector<BYTE> _library_data;
+    ComPtr<ID3D12PipelineLibrary> _library;
+    bool _modified = false;
+    std::unordered_map<UINT64, ComPtr<ID3D12RootSignature>> _root_signatures;
+    std::unordered_map<ID3D12RootSignature *, UINT64> _root_signature_keys;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
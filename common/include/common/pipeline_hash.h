@@ -0,0 +1,32 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#ifndef PIPELINE_HASH_H_
+#define PIPELINE_HASH_H_
+
+#include <d3d12.h>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+constexpr UINT32 kPipelineCacheVersion = 1;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Hash the description of a root signature. A key depends only on values of a description, not on addresses,
+//! so it is stable across runs.
+//! \param desc The description of a root signature.
+//! \return A key.
+extern UINT64 HashRootSignatureDesc(const D3D12_ROOT_SIGNATURE_DESC &desc);
+
+//! Hash the description of a graphics pipeline state. Shaders are hashed by their bytecode, and the root signature
+//! is hashed by its key, because a description only refers to it.
+//! \param desc The description of a graphics pipeline state.
+//! \param root_signature_key The key of the root signature of a description.
+//! \return A key.
+extern UINT64 HashGraphicsPipelineDesc(const D3D12_GRAPHICS_PIPELINE_STATE_DESC &desc, UINT64 root_signature_key);
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
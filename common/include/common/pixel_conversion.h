@@ -0,0 +1,93 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#ifndef PIXEL_CONVERSION_H_
+#define PIXEL_CONVERSION_H_
+
+#include <Windows.h>
+#include <cstddef>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Instruction sets of conversions. x86 paths are ordered, so a path implies the former ones.
+enum class PixelConversionPath {
+    kScalar,
+    kSSE4,
+    kAVX2,
+    kNEON
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Retrieve the path of conversions. The fastest path is selected by the features of a CPU at run time,
+//! so the library doesn't need to be built for an instruction set.
+//! \return A path.
+extern PixelConversionPath GetPixelConversionPath();
+
+//! Limit the path of conversions to compare paths in tests and benchmarks. A path which a CPU doesn't support is
+//! lowered to the fastest supported one. It must not be called while conversions are running.
+//! \param path A path.
+//! \return The path which conversions use.
+extern PixelConversionPath SetPixelConversionPath(PixelConversionPath path);
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Expand RGB8 pixels to RGBA8 pixels. Alpha is filled with 255.
+//! \param src RGB8 pixels.
+//! \param dst RGBA8 pixels. It must not overlap with the source.
+//! \param count The number of pixels.
+extern void ConvertRGBToRGBA(const BYTE *src, BYTE *dst, size_t count);
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Swap red and blue of RGBA8 pixels. It converts from RGBA8 to BGRA8 and vice versa.
+//! \param src RGBA8 or BGRA8 pixels.
+//! \param dst BGRA8 or RGBA8 pixels. It can be the same as the source.
+//! \param count The number of pixels.
+extern void SwizzleRedBlue(const BYTE *src, BYTE *dst, size_t count);
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Multiply color by alpha of RGBA8 pixels. The result is rounded to nearest.
+//! \param src RGBA8 pixels.
+//! \param dst Premultiplied RGBA8 pixels. It can be the same as the source.
+//! \param count The number of pixels.
+extern void PremultiplyAlpha(const BYTE *src, BYTE *dst, size_t count);
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Convert from 8 bit unsigned normalized components to half float components.
+//! \param src 8 bit unsigned normalized components.
+//! \param dst Half float components.
+//! \param count The number of components.
+extern void ConvertUNormToHalf(const BYTE *src, UINT16 *dst, size_t count);
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Convert from sRGB RGBA8 pixels to linear RGBA16F pixels. Alpha is already linear and only normalized.
+//! \param src sRGB RGBA8 pixels.
+//! \param dst Linear RGBA16F pixels.
+//! \param count The number of pixels.
+extern void ConvertSRGBToLinearHalf(const BYTE *src, UINT16 *dst, size_t count);
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Convert from float components to half float components. The result is rounded to nearest even.
+//! \param src Float components.
+//! \param dst Half float components.
+//! \param count The number of components.
+extern void ConvertFloatToHalf(const float *src, UINT16 *dst, size_t count);
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Convert from RGBA32F pixels to R11G11B10F pixels. Alpha is dropped and negative values are clamped to zero.
+//! \param src RGBA32F pixels.
+//! \param dst R11G11B10F pixels.
+//! \param count The number of pixels.
+extern void ConvertFloatToR11G11B10(const float *src, UINT32 *dst, size_t count);
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
@@ -0,0 +1,261 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <Windows.h>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+//----------------------------------------------------------------------------------------------------------------------
+
+constexpr UINT64 kProfileBufferCapacity = 16384;
+constexpr size_t kProfileHistoryFrameCount = 120;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! A zone which is left. The time is measured in ticks of Profiler::Now.
+struct ProfileEvent {
+    const char *name;
+    UINT64 begin;
+    UINT64 end;
+    UINT32 thread;
+    UINT32 depth;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! A zone of a frame which is aggregated by its path. Nodes are in the pre-order, and a thread is a node of
+//! the depth 0 whose children are zones of a thread. The time is measured in nanoseconds.
+struct ProfileNode {
+    std::string name;
+    UINT32 depth;
+    UINT32 count;
+    UINT64 time;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class ProfileBuffer final {
+public:
+    //! Constructor.
+    //! \param thread The index of a thread which owns a buffer.
+    //! \param name The name of a thread.
+    ProfileBuffer(UINT32 thread, std::string name);
+
+    //! Enter a zone. It is called only by the owner thread.
+    inline void Enter() {
+        ++_depth;
+    }
+
+    //! Leave a zone and write it. It is called only by the owner thread, and it never blocks.
+    //! The oldest event is overwritten when a buffer is full.
+    //! \param name The name of a zone.
+    //! \param begin The time when a zone is entered.
+    //! \param end The time when a zone is left.
+    inline void Leave(const char *name, UINT64 begin, UINT64 end) {
+        auto index = _write_index.load(std::memory_order_relaxed);
+
+        // Claim a slot before writing it, so a reader can detect a slot which is overwritten while it is read.
+        _claim_index.store(index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        auto &slot = _slots[index & (kProfileBufferCapacity - 1)];
+        slot.name.store(name, std::memory_order_relaxed);
+        slot.begin.store(begin, std::memory_order_relaxed);
+        slot.end.store(end, std::memory_order_relaxed);
+        slot.depth.store(--_depth, std::memory_order_relaxed);
+        _write_index.store(index + 1, std::memory_order_release);
+    }
+
+    //! Read events which are written since the last read. It is called only by a single reader.
+    //! \param events A vector that receives events.
+    void Read(std::vector<ProfileEvent> *events);
+
+    //! Set the name of a thread.
+    //! \param name The name of a thread.
+    void SetName(std::string name);
+
+    //! Retrieve the name of a thread.
+    //! \return The name of a thread.
+    [[nodiscard]]
+    std::string GetName() const;
+
+    //! Retrieve the index of a thread.
+    //! \return The index of a thread.
+    [[nodiscard]]
+    inline auto GetThread() const {
+        return _thread;
+    }
+
+private:
+    struct Slot {
+        std::atomic<const char *> name;
+        std::atomic<UINT64> begin;
+        std::atomic<UINT64> end;
+        std::atomic<UINT32> depth;
+    };
+
+    static_assert((kProfileBufferCapacity & (kProfileBufferCapacity - 1)) == 0);
+
+private:
+    std::unique_ptr<Slot[]> _slots;
+    std::atomic<UINT64> _write_index = 0;
+    std::atomic<UINT64> _claim_index = 0;
+    UINT64 _read_index = 0;
+    UINT32 _thread = 0;
+    UINT32 _depth = 0;
+    mutable std::mutex _name_mutex;
+    std::string _name;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class Profiler final {
+public:
+    //! Retrieve a profiler.
+    //! \return A profiler.
+    [[nodiscard]]
+    static Profiler *GetInstance();
+
+    //! Retrieve the current time. It reads the time stamp counter where it is available, because it is
+    //! much cheaper than a system clock. Ticks are converted to nanoseconds when events are collected.
+    //! \return The current time in ticks.
+    [[nodiscard]]
+    static inline UINT64 Now() {
+#if defined(_M_X64) || defined(__x86_64__)
+        return __rdtsc();
+#else
+        return GetClockTime();
+#endif
+    }
+
+    //! Retrieve the buffer of the current thread. A buffer is created when a thread profiles first, and it lives
+    //! until a program exits.
+    //! \return A buffer.
+    [[nodiscard]]
+    static inline ProfileBuffer *GetThreadBuffer() {
+        thread_local ProfileBuffer *buffer = GetInstance()->RegisterThread();
+        return buffer;
+    }
+
+    //! Set the name of the current thread, which is shown instead of its index.
+    //! \param name The name of a thread.
+    static void SetThreadName(std::string name);
+
+    //! Collect events of every thread and aggregate them into a frame. It must be called every frame.
+    void EndFrame();
+
+    //! Retrieve the last frame.
+    //! \return Nodes of the last frame.
+    [[nodiscard]]
+    inline const auto &GetFrame() const {
+        return _frame;
+    }
+
+    //! Draw the last frame as a tree. It must be called in an ImGui window.
+    void DrawImGui() const;
+
+    //! Export recent frames in the Chrome trace event format, which is opened by chrome://tracing or Perfetto.
+    //! \param path A file path.
+    void ExportChromeTrace(const std::filesystem::path &path) const;
+
+private:
+    //! Constructor.
+    Profiler();
+
+    //! Retrieve the time of a system clock.
+    //! \return The current time in nanoseconds.
+    [[nodiscard]]
+    static inline UINT64 GetClockTime() {
+        auto now = std::chrono::steady_clock::now().time_since_epoch();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+    }
+
+    //! Update the period of a tick by comparing ticks and a system clock since a profiler is created.
+    void UpdateTickPeriod();
+
+    //! Convert ticks to nanoseconds.
+    //! \param ticks Ticks.
+    //! \return Nanoseconds.
+    [[nodiscard]]
+    inline double ToNanoseconds(UINT64 ticks) const {
+        return static_cast<double>(ticks) * _tick_period;
+    }
+
+    //! Create the buffer of the current thread.
+    //! \return A buffer.
+    ProfileBuffer *RegisterThread();
+
+    //! Aggregate events of a thread into the last frame.
+    //! \param buffer The buffer of a thread.
+    //! \param events Events of a thread. They are sorted by the time when a zone is entered.
+    void Aggregate(const ProfileBuffer &buffer, std::span<ProfileEvent> events);
+
+private:
+    UINT64 _epoch = 0;
+    UINT64 _clock_epoch = 0;
+    double _tick_period = 1.0;
+    mutable std::mutex _mutex;
+    std::vector<std::unique_ptr<ProfileBuffer>> _buffers;
+    std::vector<ProfileEvent> _events;
+    std::vector<ProfileNode> _frame;
+    std::deque<std::vector<ProfileEvent>> _history;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class ProfileZone final {
+public:
+    //! Constructor. Enter a zone.
+    //! \param name The name of a zone. It must be alive until a program exits, for example a string literal.
+    explicit ProfileZone(const char *name)
+            : _name(name), _buffer(Profiler::GetThreadBuffer()) {
+        _buffer->Enter();
+        _begin = Profiler::Now();
+    }
+
+    //! Copy constructor. It is deleted because a zone is entered once.
+    ProfileZone(const ProfileZone &) = delete;
+
+    //! Destructor. Leave a zone.
+    ~ProfileZone() {
+        _buffer->Leave(_name, _begin, Profiler::Now());
+    }
+
+private:
+    const char *_name = nullptr;
+    ProfileBuffer *_buffer = nullptr;
+    UINT64 _begin = 0;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#define PROFILE_ZONE_NAME_(line) profile_zone_##line
+#define PROFILE_ZONE_NAME(line) PROFILE_ZONE_NAME_(line)
+
+//! Profile a scope until it ends.
+//! \param name The name of a zone. It must be alive until a program exits, for example a string literal.
+#define ProfileScope(name) ProfileZone PROFILE_ZONE_NAME(__LINE__)(name)
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
@@ -17,6 +17,10 @@ using Microsoft::WRL::ComPtr;
 
 //----------------------------------------------------------------------------------------------------------------------
 
+struct Image;
+
+//----------------------------------------------------------------------------------------------------------------------
+
 class ResourceUploader final {
 public:
     //! Constructor.
@@ -39,6 +43,19 @@ public:
     //! \param size A size of the data.
     void RecordCopyData(ID3D12Resource *buffer, UINT mip_slice, const void *data, UINT64 size);
 
+    //! Record a copy data command.
+    //! \param buffer A destination buffer.
+    //! \param mip_slice The mip slice of a destination buffer.
+    //! \param array_slice The array slice of a destination buffer.
+    //! \param data The data will be copied to a destination buffer.
+    //! \param size A size of the data.
+    void RecordCopyData(ID3D12Resource *buffer, UINT mip_slice, UINT array_slice, const void *data, UINT64 size);
+
+    //! Record a copy data command for all subresources of an image. Subresources are copied through one upload buffer.
+    //! \param buffer A destination buffer which has the same layout as an image.
+    //! \param image An image.
+    void RecordCopyData(ID3D12Resource *buffer, const Image &image);
+
     //! Execute recorded copy data commands.
     void Execute();
 
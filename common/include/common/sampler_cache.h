@@ -0,0 +1,66 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#ifndef SAMPLER_CACHE_H_
+#define SAMPLER_CACHE_H_
+
+#include <wrl.h>
+#include <d3d12.h>
+#include <unordered_map>
+#include <vector>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+using Microsoft::WRL::ComPtr;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class SamplerCache final {
+public:
+    //! Constructor.
+    //! \param device A device.
+    //! \param capacity The number of sampler descriptors in a shader visible heap.
+    explicit SamplerCache(ID3D12Device *device, UINT capacity = D3D12_MAX_SHADER_VISIBLE_SAMPLER_HEAP_SIZE);
+
+    //! Retrieve a sampler. An equal sampler is shared, and a new sampler is created in a slot whose frames
+    //! are completed, so it never waits for the GPU.
+    //! \param desc The description of a sampler.
+    //! \param fence_value The fence value which is signaled when a frame using a sampler is completed.
+    //! \param completed_fence_value The completed fence value.
+    //! \return The index of a sampler in the descriptor heap.
+    UINT GetSampler(const D3D12_SAMPLER_DESC &desc, UINT64 fence_value, UINT64 completed_fence_value);
+
+    //! Retrieve the descriptor heap of samplers.
+    //! \return A descriptor heap.
+    [[nodiscard]]
+    inline ID3D12DescriptorHeap *GetDescriptorHeap() const {
+        return _descriptor_heap.Get();
+    }
+
+    //! Retrieve the GPU descriptor handle of a sampler.
+    //! \param index The index of a sampler.
+    //! \return A GPU descriptor handle.
+    [[nodiscard]]
+    D3D12_GPU_DESCRIPTOR_HANDLE GetGPUHandle(UINT index) const;
+
+private:
+    struct Slot {
+        D3D12_SAMPLER_DESC desc;
+        UINT64 fence_value;
+        bool occupied;
+    };
+
+private:
+    ID3D12Device *_device = nullptr;
+    ComPtr<ID3D12DescriptorHeap> _descriptor_heap;
+    UINT _descriptor_size = 0;
+    std::vector<Slot> _slots;
+    std::unordered_multimap<UINT64, UINT> _indices;
+    UINT _next = 0;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
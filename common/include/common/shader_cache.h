@@ -0,0 +1,73 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#ifndef SHADER_CACHE_H_
+#define SHADER_CACHE_H_
+
+#include <Windows.h>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+constexpr UINT32 kShaderCacheMagic = 0x43535844; // 'DXSC'
+constexpr UINT32 kShaderCacheVersion = 2;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct ShaderCacheHeader {
+    UINT32 magic;
+    UINT32 version;
+    UINT64 key;
+    UINT64 size;
+    UINT32 dependency_count;
+    UINT32 dependencies_size;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct CachedShader {
+    std::vector<BYTE> code;
+    std::vector<std::filesystem::path> dependencies;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class ShaderCache final {
+public:
+    //! Constructor.
+    //! \param directory A directory to store compiled shaders. It is created if it doesn't exist.
+    explicit ShaderCache(const std::filesystem::path &directory);
+
+    //! Load a compiled shader. A truncated or mismatched file, or a file whose size doesn't match its header, is
+    //! treated as a miss.
+    //! \param key A key of a compiled shader.
+    //! \return A compiled shader and its dependencies if a key is cached.
+    [[nodiscard]]
+    std::optional<CachedShader> Load(UINT64 key) const;
+
+    //! Store a compiled shader. A file is written to a temporary file and renamed,
+    //! so a concurrent load never reads a partially written file.
+    //! \param key A key of a compiled shader.
+    //! \param code A compiled shader.
+    //! \param dependencies Files which a shader is compiled from.
+    void Store(UINT64 key, std::span<const BYTE> code, std::span<const std::filesystem::path> dependencies) const;
+
+private:
+    //! Build the file path of a key.
+    //! \param key A key of a compiled shader.
+    //! \return A file path.
+    [[nodiscard]]
+    std::filesystem::path BuildPath(UINT64 key) const;
+
+private:
+    std::filesystem::path _directory;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
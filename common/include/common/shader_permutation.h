@@ -0,0 +1,69 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#ifndef SHADER_PERMUTATION_H_
+#define SHADER_PERMUTATION_H_
+
+#include <Windows.h>
+#include <future>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "compiler.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class ShaderPermutation final {
+public:
+    //! Constructor. The fallback variant is compiled at once, and other variants are compiled on demand.
+    //! \param compiler A compiler.
+    //! \param request A shader to compile. Keywords are added to its defines.
+    //! \param keywords Keywords of a shader. A variant defines a keyword as 1 if its bit is set, otherwise as 0.
+    //! \param fallback_mask A variant which is served until a requested variant is compiled.
+    //! It should support every feature which other variants do.
+    ShaderPermutation(Compiler *compiler, ShaderRequest request, std::vector<std::wstring> keywords,
+                      UINT32 fallback_mask);
+
+    //! Destructor. Wait for compiles in flight.
+    ~ShaderPermutation();
+
+    //! Request a variant. A variant which isn't compiled yet is compiled in the background.
+    //! A variant which fails to compile is never retried until a permutation is reset.
+    //! \param mask A bitmask of keywords.
+    //! \param served_mask A pointer to a variable that receives the bitmask of a returned variant.
+    //! \return The requested variant if it is compiled, otherwise the fallback variant.
+    IDxcBlob *GetVariant(UINT32 mask, UINT32 *served_mask = nullptr);
+
+    //! Discard all variants, for example when a source is modified. The fallback variant is compiled at once.
+    void Reset();
+
+private:
+    struct Variant {
+        std::future<ShaderResult> future;
+        ComPtr<IDxcBlob> code;
+        bool failed = false;
+    };
+
+    //! Build a request of a variant.
+    //! \param mask A bitmask of keywords.
+    //! \return A request.
+    [[nodiscard]]
+    ShaderRequest BuildRequest(UINT32 mask) const;
+
+    //! Compile the fallback variant.
+    void CompileFallback();
+
+private:
+    Compiler *_compiler = nullptr;
+    ShaderRequest _request;
+    std::vector<std::wstring> _keywords;
+    UINT32 _fallback_mask = 0;
+    std::unordered_map<UINT32, Variant> _variants;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
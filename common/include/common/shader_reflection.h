@@ -0,0 +1,118 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#ifndef SHADER_REFLECTION_H_
+#define SHADER_REFLECTION_H_
+
+#include <wrl.h>
+#include <d3d12.h>
+#include <d3d12shader.h>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+using Microsoft::WRL::ComPtr;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class InputLayout final {
+public:
+    //! Constructor. Vertices are assumed to be in a single slot, and components are 32 bit values packed in
+    //! the order of the input signature. System values such as SV_VertexID are skipped.
+    //! \param reflection The reflection of a vertex shader.
+    explicit InputLayout(ID3D12ShaderReflection *reflection);
+
+    //! Copy constructor. It is deleted because elements point to semantic names of a layout.
+    InputLayout(const InputLayout &) = delete;
+
+    //! Retrieve the description of an input layout. It is valid while a layout is alive.
+    //! \return The description of an input layout.
+    [[nodiscard]]
+    inline D3D12_INPUT_LAYOUT_DESC GetDesc() const {
+        return {_elements.data(), static_cast<UINT>(_elements.size())};
+    }
+
+    //! Retrieve the hash of an input layout. Equal layouts have the same hash.
+    //! \return A hash.
+    [[nodiscard]]
+    inline UINT64 GetHash() const {
+        return _hash;
+    }
+
+private:
+    std::vector<std::string> _semantic_names;
+    std::vector<D3D12_INPUT_ELEMENT_DESC> _elements;
+    UINT64 _hash = 0;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct RootBinding {
+    UINT parameter_index;
+    UINT table_offset;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class RootSignatureLayout final {
+public:
+    //! Constructor. Bindings of shaders are merged into a minimal root signature:
+    //! * A small constant buffer becomes root constants and other constant buffers become root descriptors,
+    //!   while root arguments fit in 64 DWORDs. Constant buffers which don't fit are put to a descriptor table.
+    //! * Descriptors of the same heap are merged into a single descriptor table.
+    //! * Stages which have no shader are denied root access.
+    //! \param reflections Reflections of shaders of a pipeline.
+    //! \param static_samplers Static samplers. A sampler of the same register isn't put to a descriptor table.
+    explicit RootSignatureLayout(std::span<ID3D12ShaderReflection *const> reflections,
+                                 std::span<const D3D12_STATIC_SAMPLER_DESC> static_samplers = {});
+
+    //! Copy constructor. It is deleted because parameters point to descriptor ranges of a layout.
+    RootSignatureLayout(const RootSignatureLayout &) = delete;
+
+    //! Retrieve the description of a root signature. It is valid while a layout is alive.
+    //! \return The description of a root signature.
+    [[nodiscard]]
+    inline const D3D12_ROOT_SIGNATURE_DESC &GetDesc() const {
+        return _desc;
+    }
+
+    //! Retrieve the hash of a root signature. Equal root signatures have the same hash.
+    //! \return A hash.
+    [[nodiscard]]
+    inline UINT64 GetHash() const {
+        return _hash;
+    }
+
+    //! Retrieve the canonical encoding of a root signature, which is hashed.
+    //! \return The encoding of a root signature.
+    [[nodiscard]]
+    inline const auto &GetEncoding() const {
+        return _encoding;
+    }
+
+    //! Find where a resource is bound.
+    //! \param name The name of a resource in shaders.
+    //! \return The index of a root parameter and the offset in a descriptor table, if a resource is bound.
+    [[nodiscard]]
+    std::optional<RootBinding> FindBinding(std::string_view name) const;
+
+private:
+    std::vector<D3D12_ROOT_PARAMETER> _parameters;
+    std::vector<std::vector<D3D12_DESCRIPTOR_RANGE>> _ranges;
+    std::vector<D3D12_STATIC_SAMPLER_DESC> _static_samplers;
+    D3D12_ROOT_SIGNATURE_DESC _desc = {};
+    std::unordered_map<std::string, RootBinding> _bindings;
+    std::vector<UINT32> _encoding;
+    UINT64 _hash = 0;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
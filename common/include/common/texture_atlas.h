@@ -0,0 +1,81 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#ifndef TEXTURE_ATLAS_H_
+#define TEXTURE_ATLAS_H_
+
+#include <Windows.h>
+#include <vector>
+#include <span>
+
+#include "image_loader.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct AtlasRegion {
+    UINT page;
+    float scale_u;
+    float scale_v;
+    float offset_u;
+    float offset_v;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class TextureAtlas final {
+public:
+    //! Constructor. Images are packed into pages, and then pages are filled and their mips are generated on worker
+    //! threads. A region is surrounded by a gutter of its edge texels, so mips and bilinear filtering don't bleed.
+    //! \param images Images of an uncompressed RGBA8 or BGRA8 format. All images must have the same format.
+    //! An atlas of no images has no pages.
+    //! \param page_size The width and the height of a page in texels. It must be a multiple of the smallest mip.
+    //! \param mip_levels The number of mips of a page.
+    TextureAtlas(std::span<const Image *const> images, UINT page_size, UINT16 mip_levels);
+
+    //! Retrieve pages. Each page is a texture which has all mips.
+    //! \return Pages.
+    [[nodiscard]]
+    inline const auto &GetPages() const {
+        return _pages;
+    }
+
+    //! Retrieve the UV remap table. A texture coordinate of an image is remapped to a page with "uv * scale + offset".
+    //! Wrap addressing isn't possible in a page, so texture coordinates must be in [0, 1].
+    //! \return Regions in the same order as images.
+    [[nodiscard]]
+    inline const auto &GetRegions() const {
+        return _regions;
+    }
+
+private:
+    struct Cell {
+        const Image *image;
+        UINT x;
+        UINT y;
+        UINT width;
+        UINT height;
+    };
+
+    //! Copy an image to a cell of a page. Texels outside of an image are filled by clamping to its edge.
+    //! \param cell A cell of a page.
+    //! \param page A page.
+    void FillCell(const Cell &cell, Image *page) const;
+
+    //! Generate mips of a cell of a page with a box filter.
+    //! \param cell A cell of a page.
+    //! \param page A page.
+    void GenerateMips(const Cell &cell, Image *page) const;
+
+private:
+    UINT _page_size = 0;
+    UINT16 _mip_levels = 0;
+    UINT _padding = 0;
+    std::vector<Image> _pages;
+    std::vector<AtlasRegion> _regions;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
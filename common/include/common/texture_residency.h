@@ -0,0 +1,96 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#ifndef TEXTURE_RESIDENCY_H_
+#define TEXTURE_RESIDENCY_H_
+
+#include <Windows.h>
+#include <cfloat>
+#include <vector>
+
+#include "image_loader.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct ResidencyBudget {
+    UINT64 upload_size = 16 * 1024 * 1024;
+    UINT64 memory_size = 256 * 1024 * 1024;
+    float full_detail_distance = 1.0f;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct StreamRequest {
+    UINT texture;
+    UINT16 mip_slice;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class TextureResidency final {
+public:
+    //! Constructor.
+    //! \param budget The per frame upload budget and the memory budget.
+    explicit TextureResidency(const ResidencyBudget &budget);
+
+    //! Add a texture. The smallest mips are resident immediately and must be uploaded by the caller.
+    //! \param image An image which has all mips of a texture.
+    //! \return The index of a texture.
+    UINT AddTexture(const Image &image);
+
+    //! Set the distance from the camera to a texture and mark a texture as used in this frame.
+    //! \param texture The index of a texture.
+    //! \param distance The distance from the camera.
+    void SetDistance(UINT texture, float distance);
+
+    //! Update residency. This function must be called every frame.
+    //! Evicted mips are only reflected in the resident mip, which should clamp the LOD of a texture.
+    //! \return Mips to upload in this frame, ordered from the coarse to the fine.
+    std::vector<StreamRequest> Update();
+
+    //! Retrieve the most detailed resident mip of a texture.
+    //! \param texture The index of a texture.
+    //! \return The most detailed resident mip.
+    [[nodiscard]]
+    UINT16 GetResidentMip(UINT texture) const;
+
+    //! Retrieve the mip which is required by the distance of a texture.
+    //! \param texture The index of a texture.
+    //! \return The required mip.
+    [[nodiscard]]
+    UINT16 GetRequiredMip(UINT texture) const;
+
+    //! Retrieve the total byte size of resident mips.
+    //! \return The total byte size.
+    [[nodiscard]]
+    inline auto GetResidentSize() const {
+        return _resident_size;
+    }
+
+private:
+    struct Texture {
+        std::vector<UINT64> mip_sizes;
+        UINT16 tail_mip = 0;
+        UINT16 resident_mip = 0;
+        float distance = FLT_MAX;
+        UINT64 last_used_frame = 0;
+    };
+
+    //! Evict mips until the given size fits to the memory budget.
+    //! \param size The byte size is going to be resident.
+    //! \param keep The index of a texture which must not be evicted.
+    //! \return True if the given size fits to the memory budget.
+    bool EvictFor(UINT64 size, UINT keep);
+
+private:
+    ResidencyBudget _budget;
+    std::vector<Texture> _textures;
+    UINT64 _resident_size = 0;
+    UINT64 _frame = 0;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
@@ -0,0 +1,70 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#ifndef THREAD_POOL_H_
+#define THREAD_POOL_H_
+
+#include <Windows.h>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class ThreadPool final {
+public:
+    //! Constructor.
+    //! \param thread_count The number of worker threads. It bounds the number of tasks in flight.
+    explicit ThreadPool(UINT thread_count);
+
+    //! Destructor. Wait until all submitted tasks are completed.
+    ~ThreadPool();
+
+    //! Submit a task. A task is executed on a worker thread in the order of submission.
+    //! \param function A task.
+    //! \return A future that receives the result of a task. An exception of a task is rethrown by a future.
+    template<typename Function>
+    auto Submit(Function &&function) -> std::future<std::invoke_result_t<Function>> {
+        using Result = std::invoke_result_t<Function>;
+
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+        auto future = task->get_future();
+        {
+            std::lock_guard lock(_mutex);
+            _tasks.emplace([task]() { (*task)(); });
+        }
+        _condition.notify_one();
+
+        return future;
+    }
+
+    //! Retrieve the number of worker threads.
+    //! \return The number of worker threads.
+    [[nodiscard]]
+    inline auto GetThreadCount() const {
+        return static_cast<UINT>(_threads.size());
+    }
+
+private:
+    //! Execute tasks until a thread pool is destroyed.
+    void Run();
+
+private:
+    std::vector<std::thread> _threads;
+    std::queue<std::function<void()>> _tasks;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _stop = false;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
@@ -31,6 +31,11 @@ using Resolution = std::tuple<UINT, UINT>;
 
 //----------------------------------------------------------------------------------------------------------------------
 
+//! The initial value of the FNV-1a hash.
+constexpr UINT64 kHashOffsetBasis = 14695981039346656037ull;
+
+//----------------------------------------------------------------------------------------------------------------------
+
 //! Retrieve a width from a resolution.
 //! \param resolution A resolution.
 //! \return A width.
@@ -70,6 +75,15 @@ T AlignPow2(T value, UINT64 alignment) {
 
 //----------------------------------------------------------------------------------------------------------------------
 
+//! Accumulate bytes to the FNV-1a hash. A hash depends only on bytes, so it is stable across runs.
+//! \param hash A hash, which is kHashOffsetBasis for the first bytes.
+//! \param data Bytes.
+//! \param size The size of bytes.
+//! \return A hash.
+extern UINT64 HashBytes(UINT64 hash, const void *data, size_t size);
+
+//----------------------------------------------------------------------------------------------------------------------
+
 //! Convert from UTF16 to UTF8.
 //! \param utf16 A UTF16 string.
 //! \return A UTF8 string.
@@ -251,6 +265,20 @@ extern HRESULT CreateDefaultTexture2D(ID3D12Device *device, UINT64 width, UINT h
 
 //----------------------------------------------------------------------------------------------------------------------
 
+//! Create a default texture 2D array. A cube map is an array which has 6 slices per cube.
+//! \param device A DirectX12 device.
+//! \param width The width of a texture.
+//! \param height The height of a texture.
+//! \param array_size The number of array slices of a texture.
+//! \param mip_levels The mip levels of a texture.
+//! \param format The texture format.
+//! \param buffer A pointer to a memory block that receives a pointer to ID3D12Resource.
+//! \return A result.
+extern HRESULT CreateDefaultTexture2DArray(ID3D12Device *device, UINT64 width, UINT height, UINT16 array_size,
+                                           UINT16 mip_levels, DXGI_FORMAT format, ID3D12Resource **buffer);
+
+//----------------------------------------------------------------------------------------------------------------------
+
 //! Calculate the inverse matrix.
 //! \param float4x4 A matrix for calculating the inverse matrix.
 //! \return An inverse matrix.
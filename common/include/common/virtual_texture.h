@@ -0,0 +1,169 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#ifndef VIRTUAL_TEXTURE_H_
+#define VIRTUAL_TEXTURE_H_
+
+#include <Windows.h>
+#include <dxgiformat.h>
+#include <vector>
+#include <functional>
+#include <future>
+#include <memory>
+#include <span>
+#include <unordered_map>
+
+#include "thread_pool.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+constexpr UINT32 kInvalidTileSlot = UINT32_MAX;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct TileId {
+    UINT16 mip_slice;
+    UINT16 x;
+    UINT16 y;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct VirtualTextureDesc {
+    UINT64 width = 0;
+    UINT height = 0;
+    UINT16 mip_levels = 0;
+    DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+    UINT element_size = 0; //!< The byte size of a texel, or of a 4x4 block of a block compressed format.
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Read the texels of a tile. Rows are in 4x4 blocks for a block compressed format, and texels outside of a texture
+//! are already cleared. It is called on worker threads concurrently, so it must be thread safe.
+//! \param tile A tile id.
+//! \param data The destination which has the rows of a tile.
+//! \param row_pitch The byte size of a row of a tile.
+using TileReader = std::function<void(const TileId &tile, std::span<BYTE> data, UINT64 row_pitch)>;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct TileUpload {
+    TileId tile;
+    UINT32 slot;
+    const BYTE *data;
+    UINT64 row_pitch;
+    UINT height;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Pack a tile id to the feedback format. The feedback format has a mip slice in 4 bits
+//! and the coordinates of a tile in 14 bits each.
+//! \param tile A tile id.
+//! \return A packed tile id.
+inline UINT32 PackTileId(const TileId &tile) {
+    return (static_cast<UINT32>(tile.mip_slice) << 28) | (static_cast<UINT32>(tile.y) << 14) | tile.x;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Unpack a tile id from the feedback format.
+//! \param packed A packed tile id.
+//! \return A tile id.
+inline TileId UnpackTileId(UINT32 packed) {
+    return {static_cast<UINT16>(packed >> 28), static_cast<UINT16>(packed & 0x3FFF),
+            static_cast<UINT16>((packed >> 14) & 0x3FFF)};
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class VirtualTexture final {
+public:
+    //! Constructor. A texture is read a tile at a time, so the memory of tiles is bounded by the number of slots.
+    //! \param desc The description of a texture. Up to 16 mips and 16384 tiles in each direction fit to a tile id.
+    //! \param tile_size The width and the height of a tile in texels.
+    //! \param slot_count The number of slots in the physical tile cache. It must exceed the tiles of the coarsest mip,
+    //! which are always resident.
+    //! \param reader A function which reads a tile.
+    VirtualTexture(const VirtualTextureDesc &desc, UINT tile_size, UINT slot_count, TileReader reader);
+
+    //! Destructor. Wait until all pending loads are completed.
+    ~VirtualTexture();
+
+    //! Request tiles from a feedback buffer. Duplicated requests are merged.
+    //! \param feedback Packed tile ids which are read back from a feedback buffer.
+    void RequestTiles(std::span<const UINT32> feedback);
+
+    //! Update the page table. This function must be called every frame.
+    //! Completed loads are mapped to the page table and new loads are dispatched to worker threads. A tile which fails
+    //! to be read is reported and stays unmapped until it is requested again.
+    //! \param max_loads The maximum number of loads in flight.
+    //! \return Tiles to copy to the physical tile cache in this frame.
+    std::vector<TileUpload> Update(UINT max_loads);
+
+    //! Retrieve the page table of a mip. Each entry has a slot of the physical tile cache or kInvalidTileSlot.
+    //! \param mip_slice The mip slice.
+    //! \return The page table of a mip.
+    [[nodiscard]]
+    inline const auto &GetPageTable(UINT16 mip_slice) const {
+        return _page_tables[mip_slice];
+    }
+
+    //! Retrieve the number of tiles of a mip in each direction.
+    //! \param mip_slice The mip slice.
+    //! \return The number of tiles in x and y.
+    [[nodiscard]]
+    inline auto GetTileCount(UINT16 mip_slice) const {
+        return _tile_counts[mip_slice];
+    }
+
+private:
+    struct Slot {
+        std::vector<BYTE> data;
+        UINT32 tile = kInvalidTileSlot;
+        UINT64 last_used_frame = 0;
+        bool pinned = false;
+    };
+
+    struct Load {
+        UINT32 tile;
+        UINT32 slot;
+        std::future<void> future;
+    };
+
+    //! Retrieve the index of an entry in the page table of a mip.
+    //! \param tile A tile id.
+    //! \return The index of an entry.
+    [[nodiscard]]
+    UINT GetPageIndex(const TileId &tile) const;
+
+    //! Request tiles of the coarsest mip which aren't resident. They are requested every frame until they are
+    //! loaded, because a frame may not dispatch all of them.
+    void RequestFallbackTiles();
+
+    //! Find a slot to load a tile. An empty slot is used first, then the least recently used slot.
+    //! \return A slot or kInvalidTileSlot if all slots are busy.
+    UINT32 AcquireSlot();
+
+private:
+    VirtualTextureDesc _desc;
+    TileReader _reader;
+    UINT _tile_size = 0;
+    UINT _block_dimension = 1;
+    UINT64 _tile_row_pitch = 0;
+    UINT _tile_height = 0;
+    std::vector<std::pair<UINT, UINT>> _tile_counts;
+    std::vector<std::vector<UINT32>> _page_tables;
+    std::vector<Slot> _slots;
+    std::unordered_map<UINT32, UINT> _requests;
+    std::vector<Load> _loads;
+    UINT64 _frame = 0;
+    std::unique_ptr<ThreadPool> _thread_pool;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
@@ -0,0 +1,200 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include "archive.h"
+
+#include <fmt/format.h>
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string_view>
+
+#include "compression.h"
+#include "utility.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Convert a path to the name of an entry. A name always uses '/' as a separator.
+//! \param path A relative file path.
+//! \return The name of an entry.
+inline std::string GetEntryName(const std::filesystem::path &path) {
+    return path.lexically_normal().generic_string();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Calculate the FNV-1a hash of the name of an entry.
+//! \param name The name of an entry.
+//! \return A hash.
+inline UINT64 HashEntryName(std::string_view name) {
+    return HashBytes(kHashOffsetBasis, name.data(), name.size());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Archive::Archive(const std::filesystem::path &path)
+        : _file(path) {
+    auto data = _file.GetData();
+
+    // Validate a header.
+    if (data.size() < sizeof(ArchiveHeader)) {
+        throw std::runtime_error(fmt::format("Fail to mount {}: a header is truncated.", path.string()));
+    }
+
+    auto header = reinterpret_cast<const ArchiveHeader *>(data.data());
+    if (header->magic != kArchiveMagic || header->version != kArchiveVersion) {
+        throw std::runtime_error(fmt::format("Fail to mount {}: not an archive.", path.string()));
+    }
+
+    if (!header->entry_count) {
+        return;
+    }
+
+    // Ranges are compared against the remaining size, so a corrupt offset can't wrap around.
+    if (header->toc_offset > data.size() ||
+        header->entry_count * sizeof(ArchiveEntry) > data.size() - header->toc_offset ||
+        header->names_offset > data.size() || header->names_size > data.size() - header->names_offset) {
+        throw std::runtime_error(fmt::format("Fail to mount {}: a table of contents is truncated.", path.string()));
+    }
+
+    // A table of contents is used in place, so it must be aligned.
+    if (header->toc_offset % alignof(ArchiveEntry)) {
+        throw std::runtime_error(fmt::format("Fail to mount {}: a table of contents is misaligned.", path.string()));
+    }
+
+    // A table of contents is used in place.
+    _entries = {reinterpret_cast<const ArchiveEntry *>(data.data() + header->toc_offset), header->entry_count};
+    _names = reinterpret_cast<const char *>(data.data() + header->names_offset);
+
+    for (auto &entry : _entries) {
+        if (entry.offset > data.size() || entry.stored_size > data.size() - entry.offset ||
+            entry.name_offset > header->names_size || entry.name_size > header->names_size - entry.name_offset) {
+            throw std::runtime_error(fmt::format("Fail to mount {}: an entry is out of range.", path.string()));
+        }
+
+        // An entry which is stored as is is copied to a buffer of its size.
+        if (!(entry.flags & kArchiveEntryCompressed) && entry.stored_size != entry.size) {
+            throw std::runtime_error(fmt::format("Fail to mount {}: an entry has a wrong size.", path.string()));
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+const ArchiveEntry *Archive::FindEntry(const std::filesystem::path &path) const {
+    auto name = GetEntryName(path);
+    auto hash = HashEntryName(name);
+
+    // Entries of the same hash are adjacent. A name resolves a collision.
+    auto iter = std::lower_bound(_entries.begin(), _entries.end(), hash, [](const auto &entry, UINT64 value) {
+        return entry.hash < value;
+    });
+    for (; iter != _entries.end() && iter->hash == hash; ++iter) {
+        if (std::string_view(_names + iter->name_offset, iter->name_size) == name) {
+            return &*iter;
+        }
+    }
+
+    return nullptr;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::vector<BYTE> Archive::ReadEntry(const ArchiveEntry &entry) const {
+    auto stored = _file.GetData().subspan(entry.offset, entry.stored_size);
+    std::vector<BYTE> contents(entry.size);
+
+    if (entry.flags & kArchiveEntryCompressed) {
+        DecompressLZ4(stored, contents);
+    } else {
+        std::copy(stored.begin(), stored.end(), contents.begin());
+    }
+
+    return contents;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void WriteArchive(const std::filesystem::path &path, std::span<const std::filesystem::path> directories,
+                  bool compress) {
+    // Collect files. A map keeps the order of entries in a file deterministic.
+    std::map<std::string, std::filesystem::path> files;
+    for (auto &directory : directories) {
+        for (auto &item : std::filesystem::recursive_directory_iterator(directory)) {
+            if (item.is_regular_file()) {
+                files.emplace(GetEntryName(std::filesystem::relative(item.path(), directory)),
+                              std::filesystem::absolute(item.path()));
+            }
+        }
+    }
+
+    std::ofstream fout(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!fout.is_open()) {
+        throw std::runtime_error(fmt::format("Fail to open {}.", path.string()));
+    }
+
+    // Write entries. Each entry is aligned to a page, so reading an entry never touches pages of other entries.
+    std::vector<ArchiveEntry> entries;
+    std::string names;
+    UINT64 offset = kArchiveAlignment;
+    for (auto &[name, file_path] : files) {
+        auto contents = FileSystem::GetInstance()->ReadFile(file_path);
+
+        ArchiveEntry entry = {};
+        entry.hash = HashEntryName(name);
+        entry.offset = offset;
+        entry.size = contents.size();
+        entry.name_offset = static_cast<UINT32>(names.size());
+        entry.name_size = static_cast<UINT16>(name.size());
+
+        if (compress) {
+            auto compressed = CompressLZ4(contents);
+            if (compressed.size() < contents.size()) {
+                contents = std::move(compressed);
+                entry.flags |= kArchiveEntryCompressed;
+            }
+        }
+        entry.stored_size = contents.size();
+
+        fout.seekp(static_cast<std::streamoff>(offset));
+        fout.write(reinterpret_cast<const char *>(contents.data()), static_cast<std::streamsize>(contents.size()));
+
+        entries.push_back(entry);
+        names += name;
+        offset = (offset + entry.stored_size + kArchiveAlignment - 1) / kArchiveAlignment * kArchiveAlignment;
+    }
+
+    // Write a table of contents which is sorted by hash and then by name.
+    std::sort(entries.begin(), entries.end(), [&names](const auto &lhs, const auto &rhs) {
+        if (lhs.hash != rhs.hash) {
+            return lhs.hash < rhs.hash;
+        }
+        return std::string_view(names).substr(lhs.name_offset, lhs.name_size) <
+               std::string_view(names).substr(rhs.name_offset, rhs.name_size);
+    });
+
+    ArchiveHeader header = {};
+    header.magic = kArchiveMagic;
+    header.version = kArchiveVersion;
+    header.entry_count = static_cast<UINT32>(entries.size());
+    header.names_size = static_cast<UINT32>(names.size());
+    header.toc_offset = offset;
+    header.names_offset = offset + entries.size() * sizeof(ArchiveEntry);
+
+    fout.seekp(static_cast<std::streamoff>(header.toc_offset));
+    fout.write(reinterpret_cast<const char *>(entries.data()),
+               static_cast<std::streamsize>(entries.size() * sizeof(ArchiveEntry)));
+    fout.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+    fout.seekp(0);
+    fout.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    if (!fout) {
+        throw std::runtime_error(fmt::format("Fail to write {}.", path.string()));
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
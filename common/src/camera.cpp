@@ -19,6 +19,40 @@ using namespace DirectX;
 
 //----------------------------------------------------------------------------------------------------------------------
 
+constexpr UINT kViewDirty = 0x1;
+constexpr UINT kProjectionDirty = 0x2;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Invert a rigid transform. The rotation is transposed and the translation is rotated back.
+//! \param matrix A matrix which only rotates and translates.
+//! \return An inverse matrix.
+inline XMFLOAT4X4 InvertRigid(const XMFLOAT4X4 &matrix) {
+    auto &m = matrix;
+    return {m._11, m._21, m._31, 0.0f,
+            m._12, m._22, m._32, 0.0f,
+            m._13, m._23, m._33, 0.0f,
+            -(m._41 * m._11 + m._42 * m._12 + m._43 * m._13),
+            -(m._41 * m._21 + m._42 * m._22 + m._43 * m._23),
+            -(m._41 * m._31 + m._42 * m._32 + m._43 * m._33),
+            1.0f};
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Invert a perspective projection which is built by XMMatrixPerspectiveFovLH.
+//! \param matrix A perspective projection matrix.
+//! \return An inverse matrix.
+inline XMFLOAT4X4 InvertPerspective(const XMFLOAT4X4 &matrix) {
+    auto &m = matrix;
+    return {1.0f / m._11, 0.0f, 0.0f, 0.0f,
+            0.0f, 1.0f / m._22, 0.0f, 0.0f,
+            0.0f, 0.0f, 0.0f, 1.0f / m._43,
+            0.0f, 0.0f, 1.0f, -m._33 / m._43};
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 Camera::Camera() {
     UpdatePosition();
     UpdateView();
@@ -94,6 +128,48 @@ void Camera::SetRadius(float radius) {
 
 //----------------------------------------------------------------------------------------------------------------------
 
+const XMFLOAT4X4 &Camera::GetInverseProjection() const {
+    UpdateDerived();
+    return _inverse_projection;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+const XMFLOAT4X4 &Camera::GetInverseView() const {
+    UpdateDerived();
+    return _inverse_view;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+const XMFLOAT4X4 &Camera::GetViewProjection() const {
+    UpdateDerived();
+    return _view_projection;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+const XMFLOAT4X4 &Camera::GetInverseViewProjection() const {
+    UpdateDerived();
+    return _inverse_view_projection;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+const XMFLOAT3X4 &Camera::GetViewNormal() const {
+    UpdateDerived();
+    return _view_normal;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+const Frustum &Camera::GetFrustum() const {
+    UpdateDerived();
+    return _frustum;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 void Camera::UpdatePosition() {
     if (_mode == CameraMode::kArcball) {
         _position = {_radius * cosf(_theta) * cosf(_phi),
@@ -110,6 +186,7 @@ void Camera::UpdatePosition() {
 
 void Camera::UpdateProjection() {
     XMStoreFloat4x4(&_projection, XMMatrixPerspectiveFovLH(_fov, _aspect_ratio, _near, _far));
+    _dirty |= kProjectionDirty;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -119,6 +196,34 @@ void Camera::UpdateView() {
     auto target = XMLoadFloat3(&_target);
     XMStoreFloat3(&_forward, XMVectorSubtract(position, target));
     XMStoreFloat4x4(&_view, XMMatrixLookAtLH(position, target, kYAxisVector));
+    _dirty |= kViewDirty;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Camera::UpdateDerived() const {
+    if (!_dirty) {
+        return;
+    }
+
+    if (_dirty & kViewDirty) {
+        _inverse_view = InvertRigid(_view);
+
+        // The inverse transpose of a rotation is itself, so a normal matrix drops only the translation.
+        auto view = XMLoadFloat4x4(&_view);
+        view.r[3] = g_XMIdentityR3;
+        XMStoreFloat3x4(&_view_normal, view);
+    }
+
+    if (_dirty & kProjectionDirty) {
+        _inverse_projection = InvertPerspective(_projection);
+    }
+
+    XMStoreFloat4x4(&_view_projection, XMMatrixMultiply(XMLoadFloat4x4(&_view), XMLoadFloat4x4(&_projection)));
+    XMStoreFloat4x4(&_inverse_view_projection, XMMatrixMultiply(XMLoadFloat4x4(&_inverse_projection),
+                                                                XMLoadFloat4x4(&_inverse_view)));
+    _frustum = ExtractFrustum(_view_projection);
+    _dirty = 0;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
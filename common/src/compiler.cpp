@@ -6,9 +6,18 @@
 #include "compiler.h"
 
 #include <fmt/format.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <future>
 #include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <vector>
 
 #include "utility.h"
+#include "embedded_shader.h"
 #include "file_system.h"
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -19,54 +28,229 @@ auto BuildLibraryPath(const std::string &name) {
 
 //----------------------------------------------------------------------------------------------------------------------
 
-Compiler::Compiler() {
-    InitDLLs();
-    InitCompilerAndLibrary();
-}
+//! A blob of a cached shader. It doesn't depend on the compiler, so a hit doesn't need to load it.
+class CachedBlob : public Microsoft::WRL::RuntimeClass<Microsoft::WRL::RuntimeClassFlags<Microsoft::WRL::ClassicCom>,
+                                                       IDxcBlob> {
+public:
+    //! Constructor.
+    //! \param code A compiled shader.
+    explicit CachedBlob(std::vector<BYTE> &&code)
+            : _code(std::move(code)) {
+    }
+
+    LPVOID STDMETHODCALLTYPE GetBufferPointer() override {
+        return _code.data();
+    }
+
+    SIZE_T STDMETHODCALLTYPE GetBufferSize() override {
+        return _code.size();
+    }
+
+private:
+    std::vector<BYTE> _code;
+};
 
 //----------------------------------------------------------------------------------------------------------------------
 
-HRESULT Compiler::CompileShader(const std::filesystem::path &path, const std::wstring &entrypoint,
-                                const std::wstring &target, IDxcBlob** code) {
-    auto source = FileSystem::GetInstance()->ReadFile(path);
+//! A blob of an embedded shader. It refers to the bytecode in the executable without a copy.
+class EmbeddedBlob : public Microsoft::WRL::RuntimeClass<Microsoft::WRL::RuntimeClassFlags<Microsoft::WRL::ClassicCom>,
+                                                         IDxcBlob> {
+public:
+    //! Constructor.
+    //! \param shader An embedded shader.
+    explicit EmbeddedBlob(const EmbeddedShader *shader)
+            : _shader(shader) {
+    }
+
+    LPVOID STDMETHODCALLTYPE GetBufferPointer() override {
+        return const_cast<BYTE *>(_shader->code);
+    }
+
+    SIZE_T STDMETHODCALLTYPE GetBufferSize() override {
+        return _shader->size;
+    }
 
-    // Create encoded source from the string.
-    ComPtr<IDxcBlobEncoding> encoded_source;
-    ThrowIfFailed(_library->CreateBlobWithEncodingFromPinned(source.data(), static_cast<UINT32>(source.size()),
-                                                             CP_UTF8, &encoded_source));
+private:
+    const EmbeddedShader *_shader = nullptr;
+};
 
-    // Configure compile options.
-    const wchar_t *options[] = {
-            L"-WX",           //Warnings as errors.
+//----------------------------------------------------------------------------------------------------------------------
+
+// Compile options.
+const wchar_t *kOptions[] = {
+        L"-WX",           //Warnings as errors.
 #ifdef _DEBUG
-            L"-Zi",           // Debug info.
-            L"-Qembed_debug", // Embed debug info into the shader.
-            L"-Od",           // Disable optimization.
+        L"-Zi",           // Debug info.
+        L"-Qembed_debug", // Embed debug info into the shader.
+        L"-Od",           // Disable optimization.
 #else
-            L"-O3",           // Optimization level 3.
+        L"-O3",           // Optimization level 3.
 #endif
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Accumulate a string to the FNV-1a hash. A terminator is included, so concatenated strings don't collide.
+//! \param hash A hash.
+//! \param string A string.
+//! \return A hash.
+inline UINT64 HashString(UINT64 hash, std::wstring_view string) {
+    hash = HashBytes(hash, string.data(), string.size() * sizeof(wchar_t));
+    return HashBytes(hash, L"", sizeof(wchar_t));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Accumulate a source and files which it includes to the FNV-1a hash. Include directives are found by scanning
+//! lines without preprocessing, so a conditionally skipped include is hashed too. It never misses a dependency.
+//! \param hash A hash.
+//! \param path The file path of a source.
+//! \param visited Paths of hashed sources.
+//! \return A hash.
+UINT64 HashSource(UINT64 hash, const std::filesystem::path &path, std::unordered_set<std::wstring> *visited) {
+    hash = HashString(hash, path.generic_wstring());
+    if (!visited->insert(path.generic_wstring()).second) {
+        return hash;
+    }
+
+    // A missing include fails to compile, so only its name is hashed.
+    std::vector<BYTE> source;
+    try {
+        source = FileSystem::GetInstance()->ReadFile(path);
+    }
+    catch (const std::exception &) {
+        return hash;
+    }
+    hash = HashBytes(hash, source.data(), source.size());
+
+    std::string_view text(reinterpret_cast<const char *>(source.data()), source.size());
+    for (size_t begin = 0; begin < text.size();) {
+        auto end = std::min(text.find('\n', begin), text.size());
+        auto line = text.substr(begin, end - begin);
+        begin = end + 1;
+
+        // Match "#include "name"" or "#include <name>" with optional white spaces.
+        line.remove_prefix(std::min(line.find_first_not_of(" \t"), line.size()));
+        if (!line.starts_with('#')) {
+            continue;
+        }
+        line.remove_prefix(1);
+        line.remove_prefix(std::min(line.find_first_not_of(" \t"), line.size()));
+        if (!line.starts_with("include")) {
+            continue;
+        }
+        line.remove_prefix(7);
+        line.remove_prefix(std::min(line.find_first_not_of(" \t"), line.size()));
+        if (line.empty() || (line[0] != '"' && line[0] != '<')) {
+            continue;
+        }
+
+        auto close = line.find(line[0] == '"' ? '"' : '>', 1);
+        if (close == std::string_view::npos) {
+            continue;
+        }
+
+        // An include is resolved relative to the directory of the including file.
+        auto name = ConvertUTF8ToUTF16(std::string(line.substr(1, close - 1)).c_str());
+        hash = HashSource(hash, (path.parent_path() / name).lexically_normal(), visited);
+    }
+
+    return hash;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Accumulate the size and the last write time of a file to the FNV-1a hash.
+//! \param hash A hash.
+//! \param path A file path.
+//! \return A hash.
+inline UINT64 HashFileStamp(UINT64 hash, const std::filesystem::path &path) {
+    std::error_code error_code;
+    auto size = std::filesystem::file_size(path, error_code);
+    auto time = std::filesystem::last_write_time(path, error_code).time_since_epoch().count();
+    hash = HashBytes(hash, &size, sizeof(size));
+    return HashBytes(hash, &time, sizeof(time));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Compiler::Compiler()
+        : _shader_cache(SHADER_CACHE_DIR) {
+    // A version of the compiler is identified by its DLLs, so an update of them invalidates cached shaders.
+    _compiler_version = HashFileStamp(kHashOffsetBasis, BuildLibraryPath("dxil.dll"));
+    _compiler_version = HashFileStamp(_compiler_version, BuildLibraryPath("dxcompiler.dll"));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+HRESULT Compiler::CompileShader(const std::filesystem::path &path, const std::wstring &entrypoint,
+                                const std::wstring &target, IDxcBlob** code) {
+    auto result = Compile(&_instance, {path, entrypoint, target, {}});
+
+    if (FAILED(result.result)) {
+        OutputDebugStringA(result.diagnostics.c_str());
+    } else {
+        *code = result.code.Detach();
+    }
+
+    return result.result;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::vector<ShaderResult> Compiler::CompileShaders(std::span<const ShaderRequest> requests) {
+    std::vector<ShaderResult> results(requests.size());
+    if (requests.empty()) {
+        return results;
+    }
+
+    // Workers take requests in order, so an expensive request doesn't stall requests behind it on one worker.
+    std::atomic<size_t> next = 0;
+    auto work = [this, requests, &results, &next]() {
+        Instance instance;
+        for (auto i = next++; i < requests.size(); i = next++) {
+            results[i] = Compile(&instance, requests[i]);
+        }
     };
 
-    // Compile a shader.
-    ComPtr<IDxcOperationResult> operation_result;
-    ThrowIfFailed(_compiler->Compile(encoded_source.Get(), path.c_str(), entrypoint.c_str(), target.c_str(),
-                                     options, _countof(options),
-                                     nullptr, 0,
-                                     _include_handler.Get(), &operation_result));
+    // The calling thread is one of workers, so a single request doesn't start a thread.
+    auto worker_count = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, requests.size());
+    std::vector<std::future<void>> futures;
+    for (size_t i = 1; i < worker_count; ++i) {
+        futures.push_back(std::async(std::launch::async, work));
+    }
 
-    // Verify the result.
-    HRESULT result;
-    operation_result->GetStatus(&result);
+    work();
+
+    for (auto &future : futures) {
+        future.get();
+    }
+
+    return results;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+HRESULT Compiler::ReflectShader(IDxcBlob *code, ID3D12ShaderReflection **reflection) {
+    std::call_once(_dll_flag, &Compiler::InitDLLs, this);
+
+    auto proc = reinterpret_cast<DxcCreateInstanceProc>(GetProcAddress(_dxcompiler, "DxcCreateInstance"));
+    if (!proc) {
+        throw std::runtime_error("Fail to get DxcCreateInstance.");
+    }
 
+    // Find the DXIL part of a container, which has the reflection of a shader.
+    ComPtr<IDxcContainerReflection> container_reflection;
+    ThrowIfFailed(proc(CLSID_DxcContainerReflection, IID_PPV_ARGS(&container_reflection)));
+    ThrowIfFailed(container_reflection->Load(code));
+
+    UINT32 index;
+    auto result = container_reflection->FindFirstPartKind(DXC_PART_DXIL, &index);
     if (FAILED(result)) {
-        ComPtr<IDxcBlobEncoding> error;
-        operation_result->GetErrorBuffer(&error);
-        OutputDebugStringA(static_cast<char *>(error->GetBufferPointer()));
-    } else {
-        operation_result->GetResult(code);
+        return result;
     }
 
-    return result;
+    return container_reflection->GetPartReflection(index, IID_PPV_ARGS(reflection));
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -77,6 +261,104 @@ HRESULT Compiler::CompileLibrary(const std::filesystem::path &path, IDxcBlob** c
 
 //----------------------------------------------------------------------------------------------------------------------
 
+ShaderResult Compiler::Compile(Instance *instance, const ShaderRequest &request) {
+    ShaderResult result;
+
+    // Return an embedded shader without loading the compiler. A key covers sources, so a shader whose source was
+    // modified after the build misses and is compiled again.
+    auto key = BuildCacheKey(request);
+    result.key = key;
+    if (auto embedded_shader = FindEmbeddedShader(key)) {
+        result.result = S_OK;
+        result.code = Microsoft::WRL::Make<EmbeddedBlob>(embedded_shader);
+        for (auto name = embedded_shader->dependencies; *name; name += strlen(name) + 1) {
+            result.dependencies.emplace_back(std::u8string(reinterpret_cast<const char8_t *>(name)));
+        }
+        return result;
+    }
+
+    // Return a cached shader without loading the compiler.
+    if (auto cached_shader = _shader_cache.Load(key)) {
+        result.result = S_OK;
+        result.code = Microsoft::WRL::Make<CachedBlob>(std::move(cached_shader->code));
+        result.dependencies = std::move(cached_shader->dependencies);
+        return result;
+    }
+
+    if (!instance->compiler) {
+        InitInstance(instance);
+    }
+
+    auto path = request.path.lexically_normal();
+    auto source = _include_cache.Load(path);
+    if (!source) {
+        throw std::runtime_error(fmt::format("Fail to read {}.", path.string()));
+    }
+
+    // Create encoded source from the contents. Contents are shared with other compiles of the same source.
+    auto encoded_source = CreateSourceBlob(std::move(source));
+
+    // Configure defines.
+    std::vector<DxcDefine> defines;
+    for (auto &define : request.defines) {
+        defines.push_back({define.name.c_str(), define.value.empty() ? nullptr : define.value.c_str()});
+    }
+
+    // Compile a shader. A handler is created for each compile to record includes of a shader.
+    auto include_handler = Microsoft::WRL::Make<IncludeHandler>(&_include_cache);
+    ComPtr<IDxcOperationResult> operation_result;
+    ThrowIfFailed(instance->compiler->Compile(encoded_source.Get(), path.c_str(),
+                                              request.entrypoint.c_str(), request.target.c_str(),
+                                              kOptions, _countof(kOptions),
+                                              defines.data(), static_cast<UINT32>(defines.size()),
+                                              include_handler.Get(), &operation_result));
+
+    // Verify the result.
+    operation_result->GetStatus(&result.result);
+
+    ComPtr<IDxcBlobEncoding> error;
+    operation_result->GetErrorBuffer(&error);
+    if (error && error->GetBufferSize()) {
+        result.diagnostics.assign(static_cast<const char *>(error->GetBufferPointer()), error->GetBufferSize());
+    }
+
+    result.dependencies.push_back(path);
+    for (auto &dependency : include_handler->GetDependencies()) {
+        if (dependency != path) {
+            result.dependencies.push_back(dependency);
+        }
+    }
+
+    if (SUCCEEDED(result.result)) {
+        operation_result->GetResult(&result.code);
+
+        auto data = static_cast<const BYTE *>(result.code->GetBufferPointer());
+        _shader_cache.Store(key, {data, result.code->GetBufferSize()}, result.dependencies);
+    }
+
+    return result;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+UINT64 Compiler::BuildCacheKey(const ShaderRequest &request) const {
+    std::unordered_set<std::wstring> visited;
+    auto key = HashSource(_compiler_version, request.path.lexically_normal(), &visited);
+    key = HashString(key, request.entrypoint);
+    key = HashString(key, request.target);
+    for (auto &define : request.defines) {
+        key = HashString(key, define.name);
+        key = HashString(key, define.value);
+    }
+    for (auto option : kOptions) {
+        key = HashString(key, option);
+    }
+
+    return key;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 void Compiler::InitDLLs() {
     // dxil should be loaded before loading dxcompiler.
     // If this rule isn't keep, the compiler can't generate the intermediate language.
@@ -93,15 +375,15 @@ void Compiler::InitDLLs() {
 
 //----------------------------------------------------------------------------------------------------------------------
 
-void Compiler::InitCompilerAndLibrary() {
+void Compiler::InitInstance(Instance *instance) {
+    std::call_once(_dll_flag, &Compiler::InitDLLs, this);
+
     auto proc = reinterpret_cast<DxcCreateInstanceProc>(GetProcAddress(_dxcompiler, "DxcCreateInstance"));
     if (!proc) {
         throw std::runtime_error("Fail to get DxcCreateInstance.");
     }
 
-    ThrowIfFailed(proc(CLSID_DxcCompiler, IID_PPV_ARGS(&_compiler)));
-    ThrowIfFailed(proc(CLSID_DxcLibrary, IID_PPV_ARGS(&_library)));
-    ThrowIfFailed(_library->CreateIncludeHandler(&_include_handler));
+    ThrowIfFailed(proc(CLSID_DxcCompiler, IID_PPV_ARGS(&instance->compiler)));
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,195 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include "compression.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+constexpr size_t kMinMatch = 4;
+constexpr size_t kLastLiterals = 5;
+constexpr size_t kMatchStartLimit = 12;
+constexpr size_t kMaxOffset = 65535;
+constexpr UINT kHashLog = 16;
+constexpr UINT32 kInvalidPosition = UINT32_MAX;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Read 4 bytes without alignment.
+//! \param data Data.
+//! \return 4 bytes.
+inline UINT32 Read32(const BYTE *data) {
+    UINT32 value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Write the remainder of a length which doesn't fit to 4 bits of a token.
+//! \param length The remainder of a length.
+//! \param dst Compressed data.
+inline void WriteLength(size_t length, std::vector<BYTE> *dst) {
+    while (length >= 255) {
+        dst->push_back(255);
+        length -= 255;
+    }
+    dst->push_back(static_cast<BYTE>(length));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Read the remainder of a length which doesn't fit to 4 bits of a token.
+//! \param src Compressed data.
+//! \param position The position of compressed data.
+//! \return The remainder of a length.
+inline size_t ReadLength(std::span<const BYTE> src, size_t *position) {
+    size_t length = 0;
+    BYTE value;
+    do {
+        if (*position >= src.size()) {
+            throw std::runtime_error("Fail to decompress: a length is truncated.");
+        }
+        value = src[(*position)++];
+        length += value;
+    } while (value == 255);
+
+    return length;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Write a sequence which has literals and an optional match.
+//! \param literals Literals.
+//! \param offset The offset of a match. It is zero if a sequence doesn't have a match.
+//! \param match_length The length of a match.
+//! \param dst Compressed data.
+inline void WriteSequence(std::span<const BYTE> literals, size_t offset, size_t match_length,
+                          std::vector<BYTE> *dst) {
+    auto literal_length = literals.size();
+    auto match_code = offset ? match_length - kMinMatch : 0;
+
+    dst->push_back(static_cast<BYTE>((std::min<size_t>(literal_length, 15) << 4) | std::min<size_t>(match_code, 15)));
+    if (literal_length >= 15) {
+        WriteLength(literal_length - 15, dst);
+    }
+    dst->insert(dst->end(), literals.begin(), literals.end());
+
+    if (offset) {
+        dst->push_back(static_cast<BYTE>(offset & 0xFF));
+        dst->push_back(static_cast<BYTE>(offset >> 8));
+        if (match_code >= 15) {
+            WriteLength(match_code - 15, dst);
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::vector<BYTE> CompressLZ4(std::span<const BYTE> src) {
+    std::vector<BYTE> dst;
+    dst.reserve(src.size() + src.size() / 255 + 16);
+
+    // The last match must start 12 bytes before the end and the last 5 bytes are always literals.
+    auto size = src.size();
+    size_t anchor = 0;
+    if (size > kMatchStartLimit) {
+        std::vector<UINT32> table(1 << kHashLog, kInvalidPosition);
+
+        size_t position = 0;
+        while (position + kMatchStartLimit <= size) {
+            auto sequence = Read32(src.data() + position);
+            auto hash = (sequence * 2654435761u) >> (32 - kHashLog);
+            auto candidate = table[hash];
+            table[hash] = static_cast<UINT32>(position);
+
+            if (candidate == kInvalidPosition || position - candidate > kMaxOffset ||
+                Read32(src.data() + candidate) != sequence) {
+                ++position;
+                continue;
+            }
+
+            auto length = kMinMatch;
+            while (position + length < size - kLastLiterals && src[candidate + length] == src[position + length]) {
+                ++length;
+            }
+
+            WriteSequence(src.subspan(anchor, position - anchor), position - candidate, length, &dst);
+            position += length;
+            anchor = position;
+        }
+    }
+
+    WriteSequence(src.subspan(anchor), 0, 0, &dst);
+
+    return dst;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void DecompressLZ4(std::span<const BYTE> src, std::span<BYTE> dst) {
+    size_t src_position = 0;
+    size_t dst_position = 0;
+
+    while (src_position < src.size()) {
+        auto token = src[src_position++];
+
+        // Copy literals.
+        size_t literal_length = token >> 4;
+        if (literal_length == 15) {
+            literal_length += ReadLength(src, &src_position);
+        }
+
+        if (literal_length > src.size() - src_position || literal_length > dst.size() - dst_position) {
+            throw std::runtime_error("Fail to decompress: literals overflow.");
+        }
+
+        std::copy_n(src.data() + src_position, literal_length, dst.data() + dst_position);
+        src_position += literal_length;
+        dst_position += literal_length;
+
+        // The last sequence doesn't have a match.
+        if (src_position == src.size()) {
+            break;
+        }
+
+        // Copy a match. A match can overlap with itself when an offset is shorter than a length.
+        if (src.size() - src_position < 2) {
+            throw std::runtime_error("Fail to decompress: an offset is truncated.");
+        }
+
+        size_t offset = src[src_position] | (src[src_position + 1] << 8);
+        src_position += 2;
+
+        size_t match_length = token & 0xF;
+        if (match_length == 15) {
+            match_length += ReadLength(src, &src_position);
+        }
+        match_length += kMinMatch;
+
+        if (!offset || offset > dst_position || match_length > dst.size() - dst_position) {
+            throw std::runtime_error("Fail to decompress: a match is out of range.");
+        }
+
+        auto match = dst.data() + dst_position - offset;
+        if (offset >= match_length) {
+            memcpy(dst.data() + dst_position, match, match_length);
+        } else {
+            for (size_t i = 0; i != match_length; ++i) {
+                dst[dst_position + i] = match[i];
+            }
+        }
+        dst_position += match_length;
+    }
+
+    if (dst_position != dst.size()) {
+        throw std::runtime_error("Fail to decompress: the size doesn't match.");
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
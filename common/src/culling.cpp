@@ -0,0 +1,267 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include "culling.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectX;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Frustum ExtractFrustum(const XMFLOAT4X4 &view_projection) {
+    // A point is inside if -w <= x <= w, -w <= y <= w and 0 <= z <= w in the clip space. Vectors are rows,
+    // so each inequality is a combination of columns of a matrix.
+    auto &m = view_projection;
+    XMVECTOR x = XMVectorSet(m._11, m._21, m._31, m._41);
+    XMVECTOR y = XMVectorSet(m._12, m._22, m._32, m._42);
+    XMVECTOR z = XMVectorSet(m._13, m._23, m._33, m._43);
+    XMVECTOR w = XMVectorSet(m._14, m._24, m._34, m._44);
+
+    XMVECTOR planes[6] = {XMVectorAdd(w, x), XMVectorSubtract(w, x),
+                          XMVectorAdd(w, y), XMVectorSubtract(w, y),
+                          z, XMVectorSubtract(w, z)};
+
+    Frustum frustum;
+    for (auto i = 0; i != 6; ++i) {
+        XMStoreFloat4(&frustum.planes[i], XMPlaneNormalize(planes[i]));
+    }
+
+    return frustum;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void CullBoxes(const Frustum &frustum, const BoundingBoxes &boxes, BYTE *mask) {
+    auto &planes = frustum.planes;
+    auto count = boxes.count;
+    size_t i = 0;
+
+#if defined(_XM_AVX_INTRINSICS_)
+    // Test 8 boxes per iteration. Plane components are broadcast once.
+    __m256 a[6], b[6], c[6], d[6], abs_a[6], abs_b[6], abs_c[6];
+    for (auto p = 0; p != 6; ++p) {
+        a[p] = _mm256_set1_ps(planes[p].x);
+        b[p] = _mm256_set1_ps(planes[p].y);
+        c[p] = _mm256_set1_ps(planes[p].z);
+        d[p] = _mm256_set1_ps(planes[p].w);
+        abs_a[p] = _mm256_set1_ps(fabsf(planes[p].x));
+        abs_b[p] = _mm256_set1_ps(fabsf(planes[p].y));
+        abs_c[p] = _mm256_set1_ps(fabsf(planes[p].z));
+    }
+
+    const auto zero = _mm256_setzero_ps();
+    for (; i + 8 <= count; i += 8) {
+        auto cx = _mm256_loadu_ps(boxes.center_x + i);
+        auto cy = _mm256_loadu_ps(boxes.center_y + i);
+        auto cz = _mm256_loadu_ps(boxes.center_z + i);
+        auto ex = _mm256_loadu_ps(boxes.extent_x + i);
+        auto ey = _mm256_loadu_ps(boxes.extent_y + i);
+        auto ez = _mm256_loadu_ps(boxes.extent_z + i);
+
+        auto visible = _mm256_cmp_ps(zero, zero, _CMP_EQ_OQ);
+        for (auto p = 0; p != 6; ++p) {
+            auto distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a[p], cx), _mm256_mul_ps(b[p], cy)),
+                                          _mm256_add_ps(_mm256_mul_ps(c[p], cz), d[p]));
+            auto radius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(abs_a[p], ex), _mm256_mul_ps(abs_b[p], ey)),
+                                        _mm256_mul_ps(abs_c[p], ez));
+            visible = _mm256_and_ps(visible, _mm256_cmp_ps(_mm256_add_ps(distance, radius), zero, _CMP_GE_OQ));
+        }
+
+        mask[i / 8] = static_cast<BYTE>(_mm256_movemask_ps(visible));
+    }
+#elif defined(_XM_SSE_INTRINSICS_)
+    // Test 8 boxes per iteration as two halves of 4 boxes.
+    __m128 a[6], b[6], c[6], d[6], abs_a[6], abs_b[6], abs_c[6];
+    for (auto p = 0; p != 6; ++p) {
+        a[p] = _mm_set1_ps(planes[p].x);
+        b[p] = _mm_set1_ps(planes[p].y);
+        c[p] = _mm_set1_ps(planes[p].z);
+        d[p] = _mm_set1_ps(planes[p].w);
+        abs_a[p] = _mm_set1_ps(fabsf(planes[p].x));
+        abs_b[p] = _mm_set1_ps(fabsf(planes[p].y));
+        abs_c[p] = _mm_set1_ps(fabsf(planes[p].z));
+    }
+
+    const auto zero = _mm_setzero_ps();
+    auto test = [&](size_t offset) {
+        auto cx = _mm_loadu_ps(boxes.center_x + offset);
+        auto cy = _mm_loadu_ps(boxes.center_y + offset);
+        auto cz = _mm_loadu_ps(boxes.center_z + offset);
+        auto ex = _mm_loadu_ps(boxes.extent_x + offset);
+        auto ey = _mm_loadu_ps(boxes.extent_y + offset);
+        auto ez = _mm_loadu_ps(boxes.extent_z + offset);
+
+        auto visible = _mm_cmpeq_ps(zero, zero);
+        for (auto p = 0; p != 6; ++p) {
+            auto distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a[p], cx), _mm_mul_ps(b[p], cy)),
+                                       _mm_add_ps(_mm_mul_ps(c[p], cz), d[p]));
+            auto radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(abs_a[p], ex), _mm_mul_ps(abs_b[p], ey)),
+                                     _mm_mul_ps(abs_c[p], ez));
+            visible = _mm_and_ps(visible, _mm_cmpge_ps(_mm_add_ps(distance, radius), zero));
+        }
+
+        return _mm_movemask_ps(visible);
+    };
+
+    for (; i + 8 <= count; i += 8) {
+        mask[i / 8] = static_cast<BYTE>(test(i) | (test(i + 4) << 4));
+    }
+#elif defined(_XM_ARM_NEON_INTRINSICS_) && (defined(_M_ARM64) || defined(__aarch64__))
+    // Test 8 boxes per iteration as two halves of 4 boxes.
+    float32x4_t a[6], b[6], c[6], d[6], abs_a[6], abs_b[6], abs_c[6];
+    for (auto p = 0; p != 6; ++p) {
+        a[p] = vdupq_n_f32(planes[p].x);
+        b[p] = vdupq_n_f32(planes[p].y);
+        c[p] = vdupq_n_f32(planes[p].z);
+        d[p] = vdupq_n_f32(planes[p].w);
+        abs_a[p] = vdupq_n_f32(fabsf(planes[p].x));
+        abs_b[p] = vdupq_n_f32(fabsf(planes[p].y));
+        abs_c[p] = vdupq_n_f32(fabsf(planes[p].z));
+    }
+
+    const auto zero = vdupq_n_f32(0.0f);
+    const uint32x4_t lanes = {1, 2, 4, 8};
+    auto test = [&](size_t offset) {
+        auto cx = vld1q_f32(boxes.center_x + offset);
+        auto cy = vld1q_f32(boxes.center_y + offset);
+        auto cz = vld1q_f32(boxes.center_z + offset);
+        auto ex = vld1q_f32(boxes.extent_x + offset);
+        auto ey = vld1q_f32(boxes.extent_y + offset);
+        auto ez = vld1q_f32(boxes.extent_z + offset);
+
+        auto visible = vdupq_n_u32(0xFFFFFFFF);
+        for (auto p = 0; p != 6; ++p) {
+            auto distance = vaddq_f32(vaddq_f32(vmulq_f32(a[p], cx), vmulq_f32(b[p], cy)),
+                                      vaddq_f32(vmulq_f32(c[p], cz), d[p]));
+            auto radius = vaddq_f32(vaddq_f32(vmulq_f32(abs_a[p], ex), vmulq_f32(abs_b[p], ey)),
+                                    vmulq_f32(abs_c[p], ez));
+            visible = vandq_u32(visible, vcgeq_f32(vaddq_f32(distance, radius), zero));
+        }
+
+        return vaddvq_u32(vandq_u32(visible, lanes));
+    };
+
+    for (; i + 8 <= count; i += 8) {
+        mask[i / 8] = static_cast<BYTE>(test(i) | (test(i + 4) << 4));
+    }
+#endif
+
+    for (; i < count; i += 8) {
+        BYTE bits = 0;
+        for (size_t j = i; j != std::min(i + 8, count); ++j) {
+            bits |= static_cast<BYTE>(IsBoxVisible(frustum, boxes, j) << (j - i));
+        }
+        mask[i / 8] = bits;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void CullSpheres(const Frustum &frustum, const BoundingSpheres &spheres, BYTE *mask) {
+    auto &planes = frustum.planes;
+    auto count = spheres.count;
+    size_t i = 0;
+
+#if defined(_XM_AVX_INTRINSICS_)
+    // Test 8 spheres per iteration. Plane components are broadcast once.
+    __m256 a[6], b[6], c[6], d[6];
+    for (auto p = 0; p != 6; ++p) {
+        a[p] = _mm256_set1_ps(planes[p].x);
+        b[p] = _mm256_set1_ps(planes[p].y);
+        c[p] = _mm256_set1_ps(planes[p].z);
+        d[p] = _mm256_set1_ps(planes[p].w);
+    }
+
+    const auto zero = _mm256_setzero_ps();
+    for (; i + 8 <= count; i += 8) {
+        auto cx = _mm256_loadu_ps(spheres.center_x + i);
+        auto cy = _mm256_loadu_ps(spheres.center_y + i);
+        auto cz = _mm256_loadu_ps(spheres.center_z + i);
+        auto r = _mm256_loadu_ps(spheres.radius + i);
+
+        auto visible = _mm256_cmp_ps(zero, zero, _CMP_EQ_OQ);
+        for (auto p = 0; p != 6; ++p) {
+            auto distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a[p], cx), _mm256_mul_ps(b[p], cy)),
+                                          _mm256_add_ps(_mm256_mul_ps(c[p], cz), d[p]));
+            visible = _mm256_and_ps(visible, _mm256_cmp_ps(_mm256_add_ps(distance, r), zero, _CMP_GE_OQ));
+        }
+
+        mask[i / 8] = static_cast<BYTE>(_mm256_movemask_ps(visible));
+    }
+#elif defined(_XM_SSE_INTRINSICS_)
+    // Test 8 spheres per iteration as two halves of 4 spheres.
+    __m128 a[6], b[6], c[6], d[6];
+    for (auto p = 0; p != 6; ++p) {
+        a[p] = _mm_set1_ps(planes[p].x);
+        b[p] = _mm_set1_ps(planes[p].y);
+        c[p] = _mm_set1_ps(planes[p].z);
+        d[p] = _mm_set1_ps(planes[p].w);
+    }
+
+    const auto zero = _mm_setzero_ps();
+    auto test = [&](size_t offset) {
+        auto cx = _mm_loadu_ps(spheres.center_x + offset);
+        auto cy = _mm_loadu_ps(spheres.center_y + offset);
+        auto cz = _mm_loadu_ps(spheres.center_z + offset);
+        auto r = _mm_loadu_ps(spheres.radius + offset);
+
+        auto visible = _mm_cmpeq_ps(zero, zero);
+        for (auto p = 0; p != 6; ++p) {
+            auto distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a[p], cx), _mm_mul_ps(b[p], cy)),
+                                       _mm_add_ps(_mm_mul_ps(c[p], cz), d[p]));
+            visible = _mm_and_ps(visible, _mm_cmpge_ps(_mm_add_ps(distance, r), zero));
+        }
+
+        return _mm_movemask_ps(visible);
+    };
+
+    for (; i + 8 <= count; i += 8) {
+        mask[i / 8] = static_cast<BYTE>(test(i) | (test(i + 4) << 4));
+    }
+#elif defined(_XM_ARM_NEON_INTRINSICS_) && (defined(_M_ARM64) || defined(__aarch64__))
+    // Test 8 spheres per iteration as two halves of 4 spheres.
+    float32x4_t a[6], b[6], c[6], d[6];
+    for (auto p = 0; p != 6; ++p) {
+        a[p] = vdupq_n_f32(planes[p].x);
+        b[p] = vdupq_n_f32(planes[p].y);
+        c[p] = vdupq_n_f32(planes[p].z);
+        d[p] = vdupq_n_f32(planes[p].w);
+    }
+
+    const auto zero = vdupq_n_f32(0.0f);
+    const uint32x4_t lanes = {1, 2, 4, 8};
+    auto test = [&](size_t offset) {
+        auto cx = vld1q_f32(spheres.center_x + offset);
+        auto cy = vld1q_f32(spheres.center_y + offset);
+        auto cz = vld1q_f32(spheres.center_z + offset);
+        auto r = vld1q_f32(spheres.radius + offset);
+
+        auto visible = vdupq_n_u32(0xFFFFFFFF);
+        for (auto p = 0; p != 6; ++p) {
+            auto distance = vaddq_f32(vaddq_f32(vmulq_f32(a[p], cx), vmulq_f32(b[p], cy)),
+                                      vaddq_f32(vmulq_f32(c[p], cz), d[p]));
+            visible = vandq_u32(visible, vcgeq_f32(vaddq_f32(distance, r), zero));
+        }
+
+        return vaddvq_u32(vandq_u32(visible, lanes));
+    };
+
+    for (; i + 8 <= count; i += 8) {
+        mask[i / 8] = static_cast<BYTE>(test(i) | (test(i + 4) << 4));
+    }
+#endif
+
+    for (; i < count; i += 8) {
+        BYTE bits = 0;
+        for (size_t j = i; j != std::min(i + 8, count); ++j) {
+            bits |= static_cast<BYTE>(IsSphereVisible(frustum, spheres, j) << (j - i));
+        }
+        mask[i / 8] = bits;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
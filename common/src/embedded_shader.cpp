@@ -0,0 +1,37 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include "embedded_shader.h"
+
+#include <unordered_map>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Retrieve the registry of embedded shaders. It is created on first use, so static initialization order doesn't
+//! matter. It is only modified at static initialization, so lookups don't need a lock.
+//! \return The registry.
+auto &GetEmbeddedShaders() {
+    static std::unordered_map<UINT64, const EmbeddedShader *> shaders;
+    return shaders;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void RegisterEmbeddedShaders(std::span<const EmbeddedShader> shaders) {
+    auto &registry = GetEmbeddedShaders();
+    for (auto &shader : shaders) {
+        registry.emplace(shader.key, &shader);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+const EmbeddedShader *FindEmbeddedShader(UINT64 key) {
+    auto &registry = GetEmbeddedShaders();
+    auto iter = registry.find(key);
+    return iter != registry.end() ? iter->second : nullptr;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
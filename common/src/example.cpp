@@ -18,6 +18,7 @@ Example::Example(const std::string &title,
     InitFactory();
     InitAdapter();
     InitDevice();
+    InitPipelineCache();
     InitCommandQueue();
     InitCommandList();
     InitCommandAllocators();
@@ -46,20 +47,29 @@ void Example::BindToWindow(Window *window) {
 //----------------------------------------------------------------------------------------------------------------------
 
 void Example::Init() {
+    Profiler::SetThreadName("Main");
     _timer.Start();
 
     // Initialize by an example.
     OnInit();
+
+    // Watch files which are registered by an example.
+    auto directories = FileSystem::GetInstance()->GetDirectories();
+    _hot_reload.Start(directories);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
 void Example::Term() {
+    _hot_reload.Stop();
     WaitCommandQueueIdle();
 
     // Terminate by an example.
     OnTerm();
 
+    // Save pipeline states which were created in this run.
+    _pipeline_cache->Save();
+
     _timer.Stop();
 }
 
@@ -83,6 +93,10 @@ void Example::Resize(const Resolution &resolution) {
 //----------------------------------------------------------------------------------------------------------------------
 
 void Example::Update() {
+    // Aggregate zones of the last frame before any zone of this frame is entered.
+    Profiler::GetInstance()->EndFrame();
+    ProfileScope("Update");
+
     _timer.Tick();
 
     // Calculate FPS.
@@ -101,10 +115,17 @@ void Example::Update() {
 
     // Wait until a command list is completed.
     if (_fence->GetCompletedValue() < _fence_value_stamps[index]) {
+        ProfileScope("Wait GPU");
         _fence->SetEventOnCompletion(_fence_value_stamps[index], _event);
         WaitForSingleObject(_event, INFINITE);
     }
 
+    // Swap rebuilt objects at a frame boundary. Replaced objects may be used by a frame in flight.
+    if (_hot_reload.Update()) {
+        WaitCommandQueueIdle();
+        _hot_reload.Apply();
+    }
+
     // Update by an example.
     BeginImGuiPass();
     OnUpdate(index);
@@ -114,6 +135,8 @@ void Example::Update() {
 //----------------------------------------------------------------------------------------------------------------------
 
 void Example::Render() {
+    ProfileScope("Render");
+
     // Retrieve the current index of a swap chain.
     auto index = _swap_chain->GetCurrentBackBufferIndex();
     assert(index < kSwapChainBufferCount);
@@ -131,6 +154,7 @@ void Example::Render() {
     _fence_value_stamps[index] = _fence_value;
 
     // Preset a swap chain image.
+    ProfileScope("Present");
     ThrowIfFailed(_swap_chain->Present(0, 0));
 }
 
@@ -214,6 +238,12 @@ void Example::InitDevice() {
 
 //----------------------------------------------------------------------------------------------------------------------
 
+void Example::InitPipelineCache() {
+    _pipeline_cache = std::make_unique<PipelineCache>(_device.Get(), PIPELINE_CACHE_DIR);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 void Example::InitCommandQueue() {
     D3D12_COMMAND_QUEUE_DESC desc = {};
     desc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
@@ -386,6 +416,18 @@ void Example::BeginImGuiPass() {
     ImGui::TextUnformatted(_title.c_str());
     ImGui::TextUnformatted(ConvertUTF16ToUTF8(_adapter_desc.Description).c_str());
     ImGui::Text("%.2f ms/frame(%u FPS)", _timer.GetDeltaTime().count(), _fps);
+    if (ImGui::CollapsingHeader("Profiler")) {
+        Profiler::GetInstance()->DrawImGui();
+        if (ImGui::Button("Export Trace")) {
+            // A failure to write a trace isn't fatal, so it is reported and rendering continues.
+            try {
+                Profiler::GetInstance()->ExportChromeTrace(PROFILER_TRACE_PATH);
+            }
+            catch (const std::exception &exception) {
+                OutputDebugStringA(exception.what());
+            }
+        }
+    }
 }
 
 //----------------------------------------------------------------------------------------------------------------------
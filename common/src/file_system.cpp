@@ -6,8 +6,80 @@
 #include "file_system.h"
 
 #include <fmt/format.h>
+#include <algorithm>
 #include <memory>
 #include <fstream>
+#include <mutex>
+
+#include "archive.h"
+#include "thread_pool.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+constexpr UINT kIOThreadCount = 16;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+MappedFile::MappedFile(const std::filesystem::path &path) {
+    // Open a file.
+    _file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (_file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error(fmt::format("Fail to open {}.", path.string()));
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(_file, &size)) {
+        CloseHandle(_file);
+        throw std::runtime_error(fmt::format("Fail to get the size of {}.", path.string()));
+    }
+
+    // An empty file can't be mapped.
+    _size = static_cast<size_t>(size.QuadPart);
+    if (!_size) {
+        return;
+    }
+
+    // Map a whole file.
+    _mapping = CreateFileMappingW(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (_mapping) {
+        _data = static_cast<const BYTE *>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+    }
+
+    if (!_data) {
+        if (_mapping) {
+            CloseHandle(_mapping);
+        }
+        CloseHandle(_file);
+        throw std::runtime_error(fmt::format("Fail to map {}.", path.string()));
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+        : _file(other._file), _mapping(other._mapping), _data(other._data), _size(other._size) {
+    other._file = INVALID_HANDLE_VALUE;
+    other._mapping = nullptr;
+    other._data = nullptr;
+    other._size = 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+MappedFile::~MappedFile() {
+    if (_data) {
+        UnmapViewOfFile(_data);
+    }
+
+    if (_mapping) {
+        CloseHandle(_mapping);
+    }
+
+    if (_file != INVALID_HANDLE_VALUE) {
+        CloseHandle(_file);
+    }
+}
 
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -19,33 +91,136 @@ FileSystem *FileSystem::GetInstance() {
 //----------------------------------------------------------------------------------------------------------------------
 
 std::vector<BYTE> FileSystem::ReadFile(const std::filesystem::path &path) const {
-    std::basic_ifstream<BYTE> fin;
+    // An archive serves a read from its mapping without opening a file.
+    if (!path.is_absolute()) {
+        std::shared_lock lock(_mutex);
+        for (auto &archive : _archives) {
+            if (auto entry = archive->FindEntry(path)) {
+                return archive->ReadEntry(*entry);
+            }
+        }
+    }
+
+    auto file_path = FindFile(path);
 
     // Open a file.
+    std::ifstream fin(file_path, std::ios::in | std::ios::binary);
+    if (!fin.is_open()) {
+        throw std::runtime_error(fmt::format("Fail to open {}.", file_path.string()));
+    }
+
+    // Allocate a buffer once and read the contents from a file at once.
+    std::vector<BYTE> contents(std::filesystem::file_size(file_path));
+    if (!fin.read(reinterpret_cast<char *>(contents.data()), static_cast<std::streamsize>(contents.size()))) {
+        throw std::runtime_error(fmt::format("Fail to read {}.", file_path.string()));
+    }
+
+    return contents;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::future<std::vector<BYTE>> FileSystem::ReadFileAsync(const std::filesystem::path &path) const {
+    // I/O threads mostly wait for a disk, so there are more threads than cores to keep the queue of a disk deep.
+    static ThreadPool thread_pool(kIOThreadCount);
+    return thread_pool.Submit([this, path]() {
+        return ReadFile(path);
+    });
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+MappedFile FileSystem::MapFile(const std::filesystem::path &path) const {
+    return MappedFile(FindFile(path));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void FileSystem::AddDirectory(const std::filesystem::path &directory, INT priority) {
+    std::unique_lock lock(_mutex);
+
+    if (std::any_of(_directories.begin(), _directories.end(), [&directory](const auto &other) {
+        return other.path == directory;
+    })) {
+        return;
+    }
+
+    // Insert after directories of the same priority, so the search order is deterministic.
+    auto iter = std::find_if(_directories.begin(), _directories.end(), [priority](const auto &other) {
+        return other.priority < priority;
+    });
+    _directories.insert(iter, {directory, priority});
+
+    // A new directory may shadow resolved paths.
+    _resolved_paths.clear();
+    ++_generation;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::vector<std::filesystem::path> FileSystem::GetDirectories() const {
+    std::shared_lock lock(_mutex);
+
+    std::vector<std::filesystem::path> directories;
+    for (auto &directory : _directories) {
+        directories.push_back(directory.path);
+    }
+
+    return directories;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void FileSystem::MountArchive(const std::filesystem::path &path) {
+    auto archive = std::make_unique<Archive>(path);
+
+    std::unique_lock lock(_mutex);
+    _archives.push_back(std::move(archive));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::filesystem::path FileSystem::FindFile(const std::filesystem::path &path) const {
     if (path.is_absolute()) {
-        fin.open(path, std::ios::in | std::ios::binary);
-    } else {
+        if (std::filesystem::is_regular_file(path)) {
+            return path;
+        }
+
+        throw std::runtime_error(fmt::format("File isn't exist: {}.", path.string()));
+    }
+
+    std::filesystem::path file_path;
+    UINT64 generation;
+
+    // Find a file under a shared lock, so concurrent lookups don't block each other.
+    {
+        std::shared_lock lock(_mutex);
+
+        if (auto iter = _resolved_paths.find(path.native()); iter != _resolved_paths.end()) {
+            return iter->second;
+        }
+
         for (auto &directory : _directories) {
-            fin.open(fmt::format("{}/{}", directory.string(), path.string()), std::ios::in | std::ios::binary);
-            if (fin.is_open()) {
+            if (std::filesystem::is_regular_file(directory.path / path)) {
+                file_path = directory.path / path;
                 break;
             }
         }
+
+        generation = _generation;
     }
 
-    // Check file is opened.
-    if (!fin.is_open()) {
+    if (file_path.empty()) {
         throw std::runtime_error(fmt::format("File isn't exist: {}.", path.string()));
     }
 
-    // Read the contents from a file.
-    return std::vector<BYTE>(std::istreambuf_iterator<BYTE>(fin), std::istreambuf_iterator<BYTE>());
-}
-
-//----------------------------------------------------------------------------------------------------------------------
+    // Cache a resolved path unless directories were changed during a lookup.
+    std::unique_lock lock(_mutex);
+    if (generation == _generation) {
+        _resolved_paths.emplace(path.native(), file_path);
+    }
 
-void FileSystem::AddDirectory(const std::filesystem::path &directory) {
-    _directories.insert(directory);
+    return file_path;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,142 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include "file_watcher.h"
+
+#include <stdexcept>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+constexpr DWORD kBufferSize = 64 * 1024;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+FileWatcher::FileWatcher(std::span<const std::filesystem::path> directories) {
+    _stop_event = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    if (!_stop_event) {
+        throw std::runtime_error("Fail to create an event.");
+    }
+
+    // A wait can observe a limited number of handles, and one of them is the stop event.
+    for (auto &path : directories) {
+        if (_directories.size() == MAXIMUM_WAIT_OBJECTS - 1 || !std::filesystem::is_directory(path)) {
+            continue;
+        }
+
+        auto directory = std::make_unique<Directory>();
+        directory->path = path;
+        directory->handle = CreateFileW(path.c_str(), FILE_LIST_DIRECTORY,
+                                        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                                        OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+        if (directory->handle == INVALID_HANDLE_VALUE) {
+            continue;
+        }
+
+        directory->overlapped.hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+        directory->buffer.resize(kBufferSize / sizeof(DWORD));
+        ReadChanges(directory.get());
+        _directories.push_back(std::move(directory));
+    }
+
+    _thread = std::thread(&FileWatcher::Run, this);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+FileWatcher::~FileWatcher() {
+    SetEvent(_stop_event);
+    _thread.join();
+
+    // Cancel pending requests and wait for them, so the system doesn't write to freed buffers.
+    for (auto &directory : _directories) {
+        DWORD size;
+        CancelIoEx(directory->handle, &directory->overlapped);
+        GetOverlappedResult(directory->handle, &directory->overlapped, &size, TRUE);
+        CloseHandle(directory->overlapped.hEvent);
+        CloseHandle(directory->handle);
+    }
+
+    CloseHandle(_stop_event);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::vector<std::filesystem::path> FileWatcher::Poll(std::chrono::milliseconds quiet_time) {
+    std::vector<std::filesystem::path> paths;
+    auto now = std::chrono::steady_clock::now();
+
+    std::lock_guard lock(_mutex);
+    for (auto iter = _changes.begin(); iter != _changes.end();) {
+        if (now - iter->second.time < quiet_time) {
+            ++iter;
+            continue;
+        }
+
+        paths.push_back(std::move(iter->second.path));
+        iter = _changes.erase(iter);
+    }
+
+    return paths;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void FileWatcher::Run() {
+    std::vector<HANDLE> events;
+    for (auto &directory : _directories) {
+        events.push_back(directory->overlapped.hEvent);
+    }
+    events.push_back(_stop_event);
+
+    while (true) {
+        auto result = WaitForMultipleObjects(static_cast<DWORD>(events.size()), events.data(), FALSE, INFINITE);
+        auto index = result - WAIT_OBJECT_0;
+        if (index >= _directories.size()) {
+            return;
+        }
+
+        auto &directory = *_directories[index];
+        DWORD size = 0;
+        auto succeeded = GetOverlappedResult(directory.handle, &directory.overlapped, &size, FALSE);
+        auto overflowed = succeeded ? size == 0 : GetLastError() == ERROR_NOTIFY_ENUM_DIR;
+        auto now = std::chrono::steady_clock::now();
+
+        {
+            std::lock_guard lock(_mutex);
+            if (overflowed) {
+                // The buffer overflowed and changes were lost, so the whole directory is reported as changed.
+                auto path = directory.path.lexically_normal();
+                _changes[path.native()] = {path, now};
+            } else if (succeeded) {
+                // Record the last time of a change of each file.
+                auto data = reinterpret_cast<const BYTE *>(directory.buffer.data());
+                for (DWORD offset = 0;;) {
+                    auto info = reinterpret_cast<const FILE_NOTIFY_INFORMATION *>(data + offset);
+                    auto path = (directory.path / std::wstring(info->FileName, info->FileNameLength / sizeof(WCHAR)))
+                            .lexically_normal();
+                    _changes[path.native()] = {path, now};
+
+                    if (!info->NextEntryOffset) {
+                        break;
+                    }
+                    offset += info->NextEntryOffset;
+                }
+            }
+        }
+
+        ReadChanges(&directory);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void FileWatcher::ReadChanges(Directory *directory) {
+    ResetEvent(directory->overlapped.hEvent);
+    ReadDirectoryChangesW(directory->handle, directory->buffer.data(), kBufferSize, TRUE,
+                          FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE, nullptr,
+                          &directory->overlapped, nullptr);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,150 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include "hot_reload.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "file_system.h"
+
+using namespace std::chrono_literals;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+constexpr auto kQuietTime = 200ms;
+constexpr UINT kRebuildThreadCount = 2;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+HotReload::~HotReload() {
+    Stop();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+UINT HotReload::Register(const std::vector<std::filesystem::path> &dependencies, Rebuild rebuild) {
+    auto index = static_cast<UINT>(_dependents.size());
+    _dependents.push_back({std::move(rebuild), {}, false});
+    SetDependencies(index, dependencies);
+
+    return index;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HotReload::SetDependencies(UINT dependent, const std::vector<std::filesystem::path> &dependencies) {
+    // Unmap the previous files of a dependent.
+    for (auto iter = _file_dependents.begin(); iter != _file_dependents.end();) {
+        std::erase(iter->second, dependent);
+        iter = iter->second.empty() ? _file_dependents.erase(iter) : std::next(iter);
+    }
+
+    // Map resolved files to a dependent, so a change is matched by the path which was actually loaded.
+    for (auto &dependency : dependencies) {
+        auto path = FileSystem::GetInstance()->FindFile(dependency).lexically_normal();
+        auto &indices = _file_dependents[path.native()];
+        if (std::find(indices.begin(), indices.end(), dependent) == indices.end()) {
+            indices.push_back(dependent);
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HotReload::Invalidate(const std::filesystem::path &path) {
+    if (auto iter = _file_dependents.find(path.native()); iter != _file_dependents.end()) {
+        for (auto index : iter->second) {
+            _dependents[index].dirty = true;
+        }
+        return;
+    }
+
+    // A path which isn't a file of any dependent may be a directory, so files under it are marked.
+    for (auto &[file, indices] : _file_dependents) {
+        auto relative = std::filesystem::path(file).lexically_relative(path);
+        if (relative.empty() || *relative.begin() == "..") {
+            continue;
+        }
+
+        for (auto index : indices) {
+            _dependents[index].dirty = true;
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HotReload::Start(std::span<const std::filesystem::path> directories) {
+    _file_watcher = std::make_unique<FileWatcher>(directories);
+    _thread_pool = std::make_unique<ThreadPool>(kRebuildThreadCount);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HotReload::Stop() {
+    _file_watcher.reset();
+
+    for (auto &dependent : _dependents) {
+        if (dependent.future.valid()) {
+            dependent.future.wait();
+            dependent.future = {};
+        }
+        dependent.dirty = false;
+    }
+
+    _thread_pool.reset();
+    _swaps.clear();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+bool HotReload::Update() {
+    if (!_file_watcher) {
+        return false;
+    }
+
+    // Mark dependents of changed files.
+    for (auto &path : _file_watcher->Poll(kQuietTime)) {
+        Invalidate(path);
+    }
+
+    for (auto &dependent : _dependents) {
+        // Collect a completed rebuild. A failed rebuild keeps the current object, so a broken file can be fixed.
+        if (dependent.future.valid()) {
+            if (dependent.future.wait_for(0s) != std::future_status::ready) {
+                continue;
+            }
+
+            try {
+                _swaps.push_back(dependent.future.get());
+            }
+            catch (const std::exception &exception) {
+                OutputDebugStringA(exception.what());
+            }
+        }
+
+        // A dependent is rebuilt once at a time. A change during a rebuild is rebuilt after it.
+        if (dependent.dirty) {
+            dependent.dirty = false;
+            dependent.future = _thread_pool->Submit(dependent.rebuild);
+        }
+    }
+
+    return !_swaps.empty();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HotReload::Apply() {
+    for (auto &swap : _swaps) {
+        if (swap) {
+            swap();
+        }
+    }
+    _swaps.clear();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
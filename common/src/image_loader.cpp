@@ -12,24 +12,75 @@
 #include <d3dx12.h>
 #include <dds-ktx.h>
 #include <stb_image.h>
+#include <algorithm>
+#include <thread>
 
 #include "file_system.h"
+#include "pixel_conversion.h"
+#include "thread_pool.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+constexpr auto kBlockDimension = 4;
 
 //----------------------------------------------------------------------------------------------------------------------
 
 //! Cast from the DDSKTX format to the DirectX12 format.
 //! \param format The DDSKTX format.
+//! \param srgb Whether the format is in sRGB color space or not.
 //! \return The DirectX12 format.
-auto CastToFormat(ddsktx_format format) {
+auto CastToFormat(ddsktx_format format, bool srgb) {
     switch (format) {
+        case DDSKTX_FORMAT_BC1:
+            return srgb ? DXGI_FORMAT_BC1_UNORM_SRGB : DXGI_FORMAT_BC1_UNORM;
+        case DDSKTX_FORMAT_BC2:
+            return srgb ? DXGI_FORMAT_BC2_UNORM_SRGB : DXGI_FORMAT_BC2_UNORM;
+        case DDSKTX_FORMAT_BC3:
+            return srgb ? DXGI_FORMAT_BC3_UNORM_SRGB : DXGI_FORMAT_BC3_UNORM;
+        case DDSKTX_FORMAT_BC4:
+            return DXGI_FORMAT_BC4_UNORM;
+        case DDSKTX_FORMAT_BC5:
+            return DXGI_FORMAT_BC5_UNORM;
+        case DDSKTX_FORMAT_BC6H:
+            return DXGI_FORMAT_BC6H_SF16;
+        case DDSKTX_FORMAT_BC7:
+            return srgb ? DXGI_FORMAT_BC7_UNORM_SRGB : DXGI_FORMAT_BC7_UNORM;
+        case DDSKTX_FORMAT_A8:
+            return DXGI_FORMAT_A8_UNORM;
+        case DDSKTX_FORMAT_R8:
+            return DXGI_FORMAT_R8_UNORM;
         case DDSKTX_FORMAT_RGBA8:
-            return DXGI_FORMAT_R8G8B8A8_UNORM;
+            return srgb ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB : DXGI_FORMAT_R8G8B8A8_UNORM;
+        case DDSKTX_FORMAT_RGBA8S:
+            return DXGI_FORMAT_R8G8B8A8_SNORM;
+        case DDSKTX_FORMAT_RG16:
+            return DXGI_FORMAT_R16G16_UNORM;
+        case DDSKTX_FORMAT_R16:
+            return DXGI_FORMAT_R16_UNORM;
+        case DDSKTX_FORMAT_R32F:
+            return DXGI_FORMAT_R32_FLOAT;
+        case DDSKTX_FORMAT_R16F:
+            return DXGI_FORMAT_R16_FLOAT;
+        case DDSKTX_FORMAT_RG16F:
+            return DXGI_FORMAT_R16G16_FLOAT;
+        case DDSKTX_FORMAT_RG16S:
+            return DXGI_FORMAT_R16G16_SNORM;
+        case DDSKTX_FORMAT_RGBA16F:
+            return DXGI_FORMAT_R16G16B16A16_FLOAT;
+        case DDSKTX_FORMAT_RGBA16:
+            return DXGI_FORMAT_R16G16B16A16_UNORM;
         case DDSKTX_FORMAT_BGRA8:
-            return DXGI_FORMAT_B8G8R8A8_UNORM;
-        case DDSKTX_FORMAT_BC7:
-            return DXGI_FORMAT_BC7_UNORM;
+            return srgb ? DXGI_FORMAT_B8G8R8A8_UNORM_SRGB : DXGI_FORMAT_B8G8R8A8_UNORM;
+        case DDSKTX_FORMAT_RGB10A2:
+            return DXGI_FORMAT_R10G10B10A2_UNORM;
+        case DDSKTX_FORMAT_RG11B10F:
+            return DXGI_FORMAT_R11G11B10_FLOAT;
+        case DDSKTX_FORMAT_RG8:
+            return DXGI_FORMAT_R8G8_UNORM;
+        case DDSKTX_FORMAT_RG8S:
+            return DXGI_FORMAT_R8G8_SNORM;
         default:
-            throw std::runtime_error("Fail to cast to format.");
+            throw std::runtime_error(fmt::format("Fail to cast to format: {}.", ddsktx_format_str(format)));
     }
 }
 
@@ -52,26 +103,38 @@ Image LoadDDSKTX(const std::filesystem::path &path) {
         throw std::runtime_error(fmt::format("Fail to parse {}: {}.", path.string(), error.msg));
     }
 
+    // Each face of a cube map is an array slice, so a cube is 6 slices.
+    auto face_count = (info.flags & DDSKTX_TEXTURE_FLAG_CUBEMAP) ? DDSKTX_CUBE_FACE_COUNT : 1;
+
     image.width = info.width;
     image.height = info.height;
-    image.array_size = info.num_layers;
+    image.array_size = static_cast<UINT16>(info.num_layers * face_count);
     image.mip_levels = info.num_mips;
-    image.format = CastToFormat(info.format);
+    image.format = CastToFormat(info.format, info.flags & DDSKTX_TEXTURE_FLAG_SRGB);
+    image.cube = face_count == DDSKTX_CUBE_FACE_COUNT;
 
     // Read sub data of a texture.
-    image.subresources.resize(info.num_layers * info.num_mips);
+    image.subresources.resize(image.array_size * image.mip_levels);
     for (auto layer = 0; layer != info.num_layers; ++layer) {
-        for (auto mip = 0; mip != info.num_mips; ++mip) {
-            // Read sub data.
-            ddsktx_sub_data sub_data;
-            ddsktx_get_sub(&info, &sub_data, image.contents.data(), size, layer, 0, mip);
-
-            // Fill subresource.
-            auto index = D3D12CalcSubresource(mip, layer, 0, info.num_mips, info.num_layers);
-            auto &subresource = image.subresources[index];
-            subresource.data = static_cast<const BYTE *>(sub_data.buff);
-            subresource.row_pitch = sub_data.row_pitch_bytes;
-            subresource.height = sub_data.height;
+        for (auto face = 0; face != face_count; ++face) {
+            for (auto mip = 0; mip != info.num_mips; ++mip) {
+                // Read sub data.
+                ddsktx_sub_data sub_data;
+                ddsktx_get_sub(&info, &sub_data, image.contents.data(), size, layer, face, mip);
+
+                // Fill subresource.
+                auto index = D3D12CalcSubresource(mip, layer * face_count + face, 0, info.num_mips, image.array_size);
+                auto &subresource = image.subresources[index];
+                subresource.data = static_cast<const BYTE *>(sub_data.buff);
+                if (ddsktx_format_compressed(info.format)) {
+                    // A row of a block compressed format is a row of 4x4 blocks.
+                    subresource.row_pitch = sub_data.row_pitch_bytes * kBlockDimension;
+                    subresource.height = sub_data.height / kBlockDimension;
+                } else {
+                    subresource.row_pitch = sub_data.row_pitch_bytes;
+                    subresource.height = sub_data.height;
+                }
+            }
         }
     }
 
@@ -80,27 +143,130 @@ Image LoadDDSKTX(const std::filesystem::path &path) {
 
 //----------------------------------------------------------------------------------------------------------------------
 
+//! Convert 8 bit pixels to the final layout. Pixels are converted in chunks which fit in a cache,
+//! so every step reads what the previous step wrote to the cache, and memory is passed once.
+//! \param src RGB8 or RGBA8 pixels.
+//! \param components The number of components of a source pixel.
+//! \param dst Pixels of the format.
+//! \param count The number of pixels.
+//! \param format The format of 8 bit images.
+//! \param premultiplied True if colors are multiplied by alpha.
+void ConvertLDRPixels(const BYTE *src, int components, BYTE *dst, size_t count, DXGI_FORMAT format,
+                      bool premultiplied) {
+    constexpr size_t kChunkSize = 4096;
+
+    auto half = format == DXGI_FORMAT_R16G16B16A16_FLOAT;
+    auto swizzle = format == DXGI_FORMAT_B8G8R8A8_UNORM || format == DXGI_FORMAT_B8G8R8A8_UNORM_SRGB;
+
+    std::vector<BYTE> chunk(half ? kChunkSize * STBI_rgb_alpha : 0);
+    for (size_t i = 0; i < count; i += kChunkSize) {
+        auto chunk_count = std::min(kChunkSize, count - i);
+
+        // RGBA8 pixels are written to the destination unless they are converted to half floats.
+        auto rgba = half ? chunk.data() : dst + i * STBI_rgb_alpha;
+        auto pixels = src + i * components;
+        if (components == STBI_rgb) {
+            ConvertRGBToRGBA(pixels, rgba, chunk_count);
+            pixels = rgba;
+        }
+
+        if (premultiplied) {
+            PremultiplyAlpha(pixels, rgba, chunk_count);
+            pixels = rgba;
+        }
+
+        if (swizzle) {
+            SwizzleRedBlue(pixels, rgba, chunk_count);
+            pixels = rgba;
+        }
+
+        if (half) {
+            ConvertSRGBToLinearHalf(pixels, reinterpret_cast<UINT16 *>(dst) + i * STBI_rgb_alpha, chunk_count);
+        } else if (pixels != rgba) {
+            memcpy(rgba, pixels, chunk_count * STBI_rgb_alpha);
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 //! Load an image from STB file.
 //! \param path A file path.
+//! \param hdr_format The format of HDR images.
+//! \param ldr_format The format of 8 bit images.
+//! \param premultiplied True if colors of 8 bit images are multiplied by alpha.
 //! \return An image.
-Image LoadSTB(const std::filesystem::path &path) {
+Image LoadSTB(const std::filesystem::path &path, DXGI_FORMAT hdr_format, DXGI_FORMAT ldr_format,
+              bool premultiplied) {
     Image image;
 
-    // Read pixels from a file.
+    // Read the contents from a file.
+    auto file = FileSystem::GetInstance()->ReadFile(path);
+    auto file_data = file.data();
+    auto file_size = static_cast<INT>(file.size());
+
+    // Read image information.
     int x, y, channels;
-    auto contents = stbi_load(path.string().c_str(), &x, &y, &channels, STBI_rgb_alpha);
-    auto row_pitch = x * STBI_rgb_alpha;
-    auto size = row_pitch * y;
+    if (!stbi_info_from_memory(file_data, file_size, &x, &y, &channels)) {
+        throw std::runtime_error(fmt::format("Fail to parse {}: {}.", path.string(), stbi_failure_reason()));
+    }
+
+    auto count = static_cast<size_t>(x) * y;
+    UINT64 row_pitch;
+
+    if (stbi_is_hdr_from_memory(file_data, file_size)) {
+        // Decode HDR pixels to floats, then store them as half floats or packed floats.
+        auto pixels = stbi_loadf_from_memory(file_data, file_size, &x, &y, &channels, STBI_rgb_alpha);
+        if (!pixels) {
+            throw std::runtime_error(fmt::format("Fail to load {}: {}.", path.string(), stbi_failure_reason()));
+        }
+
+        if (hdr_format == DXGI_FORMAT_R11G11B10_FLOAT) {
+            row_pitch = x * sizeof(UINT32);
+            image.contents.resize(row_pitch * y);
+            ConvertFloatToR11G11B10(pixels, reinterpret_cast<UINT32 *>(image.contents.data()), count);
+        } else {
+            row_pitch = x * STBI_rgb_alpha * sizeof(UINT16);
+            image.contents.resize(row_pitch * y);
+            ConvertFloatToHalf(pixels, reinterpret_cast<UINT16 *>(image.contents.data()), count * STBI_rgb_alpha);
+        }
+        stbi_image_free(pixels);
+
+        image.format = hdr_format;
+    } else if (stbi_is_16_bit_from_memory(file_data, file_size)) {
+        // Keep 16 bit precision of pixels.
+        auto pixels = stbi_load_16_from_memory(file_data, file_size, &x, &y, &channels, STBI_rgb_alpha);
+        if (!pixels) {
+            throw std::runtime_error(fmt::format("Fail to load {}: {}.", path.string(), stbi_failure_reason()));
+        }
+
+        row_pitch = x * STBI_rgb_alpha * sizeof(UINT16);
+        image.contents.resize(row_pitch * y);
+        memcpy(image.contents.data(), pixels, image.contents.size());
+        stbi_image_free(pixels);
+
+        image.format = DXGI_FORMAT_R16G16B16A16_UNORM;
+    } else {
+        // RGB pixels are expanded to RGBA pixels by the conversion kernel, so the final layout is written in one pass.
+        auto components = channels == STBI_rgb ? STBI_rgb : STBI_rgb_alpha;
+        auto pixels = stbi_load_from_memory(file_data, file_size, &x, &y, &channels, components);
+        if (!pixels) {
+            throw std::runtime_error(fmt::format("Fail to load {}: {}.", path.string(), stbi_failure_reason()));
+        }
 
-    image.contents.resize(size);
-    memcpy(image.contents.data(), contents, size);
-    stbi_image_free(contents);
+        auto component_size = ldr_format == DXGI_FORMAT_R16G16B16A16_FLOAT ? sizeof(UINT16) : sizeof(BYTE);
+        row_pitch = x * STBI_rgb_alpha * component_size;
+        image.contents.resize(row_pitch * y);
+        ConvertLDRPixels(pixels, components, image.contents.data(), count, ldr_format, premultiplied);
+        stbi_image_free(pixels);
+
+        image.format = ldr_format;
+    }
 
     image.width = x;
     image.height = y;
     image.array_size = 1;
     image.mip_levels = 1;
-    image.format = DXGI_FORMAT_R8G8B8A8_UNORM;
 
     Subresource subresource;
     subresource.data = image.contents.data();
@@ -114,16 +280,148 @@ Image LoadSTB(const std::filesystem::path &path) {
 
 //----------------------------------------------------------------------------------------------------------------------
 
-Image ImageLoader::LoadFile(const std::filesystem::path &path) {
+//! Load an image from file by its extension.
+//! \param path A file path.
+//! \param hdr_format The format of HDR images.
+//! \param ldr_format The format of 8 bit images.
+//! \param premultiplied True if colors of 8 bit images are multiplied by alpha.
+//! \return An image.
+Image LoadImageFile(const std::filesystem::path &path, DXGI_FORMAT hdr_format, DXGI_FORMAT ldr_format,
+                    bool premultiplied) {
     auto extension = path.extension();
 
     if (extension == ".ktx" || extension == ".dds") {
         return LoadDDSKTX(path);
-    } else if (extension == ".png") {
-        return LoadSTB(path);
+    } else if (extension == ".png" || extension == ".hdr") {
+        return LoadSTB(path, hdr_format, ldr_format, premultiplied);
+    }
+
+    throw std::runtime_error(fmt::format("Fail to load {}: unsupported extension.", path.string()));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Image ImageLoader::LoadFile(const std::filesystem::path &path) {
+    return LoadImageFile(path, _hdr_format, _ldr_format, _premultiplied);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Image ImageLoader::LoadArray(std::span<const std::filesystem::path> paths) {
+    auto images = LoadFiles(paths);
+    if (images.empty()) {
+        throw std::runtime_error("Fail to load an array: no file.");
+    }
+
+    // Every slice of an array must have the same layout.
+    auto &first = images[0];
+    UINT64 size = 0;
+    UINT array_size = 0;
+    for (UINT i = 0; i != images.size(); ++i) {
+        auto &image = images[i];
+        if (image.width != first.width || image.height != first.height || image.mip_levels != first.mip_levels ||
+            image.format != first.format || image.cube != first.cube) {
+            throw std::runtime_error(fmt::format("Fail to load an array: {} doesn't match {}.", paths[i].string(),
+                                                 paths[0].string()));
+        }
+
+        for (auto &subresource : image.subresources) {
+            size += subresource.row_pitch * subresource.height;
+        }
+        array_size += image.array_size;
+    }
+
+    if (array_size > D3D12_REQ_TEXTURE2D_ARRAY_AXIS_DIMENSION) {
+        throw std::runtime_error(fmt::format("Fail to load an array: {} slices exceed the limit.", array_size));
+    }
+
+    Image array;
+    array.width = first.width;
+    array.height = first.height;
+    array.array_size = static_cast<UINT16>(array_size);
+    array.mip_levels = first.mip_levels;
+    array.format = first.format;
+    array.cube = first.cube;
+    array.contents.resize(size);
+
+    // Pack subresources tightly. Slices of each image follow slices of the previous image,
+    // which is the order of subresource indices.
+    auto data = array.contents.data();
+    for (auto &image : images) {
+        for (auto &subresource : image.subresources) {
+            auto subresource_size = subresource.row_pitch * subresource.height;
+            memcpy(data, subresource.data, subresource_size);
+            array.subresources.push_back({data, subresource.row_pitch, subresource.height});
+            data += subresource_size;
+        }
+    }
+
+    return array;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void ImageLoader::SetHDRFormat(DXGI_FORMAT format) {
+    if (format != DXGI_FORMAT_R16G16B16A16_FLOAT && format != DXGI_FORMAT_R11G11B10_FLOAT) {
+        throw std::runtime_error("HDR format must be R16G16B16A16_FLOAT or R11G11B10_FLOAT.");
+    }
+
+    _hdr_format = format;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void ImageLoader::SetLDRFormat(DXGI_FORMAT format) {
+    switch (format) {
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+        case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+        case DXGI_FORMAT_B8G8R8A8_UNORM:
+        case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+        case DXGI_FORMAT_R16G16B16A16_FLOAT:
+            _ldr_format = format;
+            break;
+        default:
+            throw std::runtime_error("LDR format must be R8G8B8A8_UNORM(_SRGB), B8G8R8A8_UNORM(_SRGB) or "
+                                     "R16G16B16A16_FLOAT.");
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void ImageLoader::SetPremultipliedAlpha(bool premultiplied) {
+    _premultiplied = premultiplied;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::future<Image> ImageLoader::LoadFileAsync(const std::filesystem::path &path) {
+    // Decoding is bound by CPU, so there is a thread for each core. Settings are copied to a task, so a loader can be
+    // reconfigured or destroyed while loads are in flight.
+    static ThreadPool thread_pool(std::thread::hardware_concurrency());
+    return thread_pool.Submit([path, hdr_format = _hdr_format, ldr_format = _ldr_format,
+                               premultiplied = _premultiplied]() {
+        return LoadImageFile(path, hdr_format, ldr_format, premultiplied);
+    });
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::vector<Image> ImageLoader::LoadFiles(std::span<const std::filesystem::path> paths) {
+    // Start loading all images, so reading and decoding of different files overlap.
+    std::vector<std::future<Image>> futures;
+    futures.reserve(paths.size());
+    for (auto &path : paths) {
+        futures.push_back(LoadFileAsync(path));
+    }
+
+    // Collect images in order. An exception of a worker thread is rethrown here.
+    std::vector<Image> images;
+    images.reserve(futures.size());
+    for (auto &future : futures) {
+        images.push_back(future.get());
     }
 
-    throw std::runtime_error("");
+    return images;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,119 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include "include_handler.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include "file_system.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! A blob of a source. It holds the contents, so a blob stays valid even after a cache entry is replaced.
+class SourceBlob : public Microsoft::WRL::RuntimeClass<Microsoft::WRL::RuntimeClassFlags<Microsoft::WRL::ClassicCom>,
+                                                       IDxcBlobEncoding> {
+public:
+    //! Constructor.
+    //! \param contents The contents of a source.
+    explicit SourceBlob(std::shared_ptr<const std::vector<BYTE>> contents)
+            : _contents(std::move(contents)) {
+    }
+
+    LPVOID STDMETHODCALLTYPE GetBufferPointer() override {
+        return const_cast<BYTE *>(_contents->data());
+    }
+
+    SIZE_T STDMETHODCALLTYPE GetBufferSize() override {
+        return _contents->size();
+    }
+
+    HRESULT STDMETHODCALLTYPE GetEncoding(BOOL *known, UINT32 *code_page) override {
+        *known = TRUE;
+        *code_page = CP_UTF8;
+        return S_OK;
+    }
+
+private:
+    std::shared_ptr<const std::vector<BYTE>> _contents;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Retrieve the last write time of a file. A file in an archive never changes, so it has no time.
+//! \param path A file path.
+//! \return The last write time.
+inline std::filesystem::file_time_type GetLastWriteTime(const std::filesystem::path &path) {
+    try {
+        return std::filesystem::last_write_time(FileSystem::GetInstance()->FindFile(path));
+    }
+    catch (const std::exception &) {
+        return {};
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::shared_ptr<const std::vector<BYTE>> IncludeCache::Load(const std::filesystem::path &path) {
+    auto time = GetLastWriteTime(path);
+
+    {
+        std::shared_lock lock(_mutex);
+        if (auto iter = _entries.find(path.native()); iter != _entries.end() && iter->second.time == time) {
+            return iter->second.contents;
+        }
+    }
+
+    std::shared_ptr<const std::vector<BYTE>> contents;
+    try {
+        contents = std::make_shared<const std::vector<BYTE>>(FileSystem::GetInstance()->ReadFile(path));
+    }
+    catch (const std::exception &) {
+        return nullptr;
+    }
+
+    std::unique_lock lock(_mutex);
+    _entries[path.native()] = {time, contents};
+
+    return contents;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+IncludeHandler::IncludeHandler(IncludeCache *cache)
+        : _cache(cache) {
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+HRESULT IncludeHandler::LoadSource(LPCWSTR filename, IDxcBlob **include_source) {
+    if (!filename || !include_source) {
+        return E_INVALIDARG;
+    }
+    *include_source = nullptr;
+
+    // The compiler joins an include to the directory of the including file, like "./shaders/common.hlsli".
+    auto path = std::filesystem::path(filename).lexically_normal();
+    auto contents = _cache->Load(path);
+    if (!contents) {
+        return E_FAIL;
+    }
+
+    if (std::find(_dependencies.begin(), _dependencies.end(), path) == _dependencies.end()) {
+        _dependencies.push_back(path);
+    }
+
+    *include_source = CreateSourceBlob(std::move(contents)).Detach();
+
+    return S_OK;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+ComPtr<IDxcBlobEncoding> CreateSourceBlob(std::shared_ptr<const std::vector<BYTE>> contents) {
+    return Microsoft::WRL::Make<SourceBlob>(std::move(contents));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,120 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include "multi_view.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+using namespace DirectX;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Directions and up vectors of cube faces, which follow the face order of a texture cube.
+constexpr std::array<XMFLOAT3, 6> kCubeFaceDirections = {XMFLOAT3(1.0f, 0.0f, 0.0f), XMFLOAT3(-1.0f, 0.0f, 0.0f),
+                                                         XMFLOAT3(0.0f, 1.0f, 0.0f), XMFLOAT3(0.0f, -1.0f, 0.0f),
+                                                         XMFLOAT3(0.0f, 0.0f, 1.0f), XMFLOAT3(0.0f, 0.0f, -1.0f)};
+constexpr std::array<XMFLOAT3, 6> kCubeFaceUps = {XMFLOAT3(0.0f, 1.0f, 0.0f), XMFLOAT3(0.0f, 1.0f, 0.0f),
+                                                  XMFLOAT3(0.0f, 0.0f, -1.0f), XMFLOAT3(0.0f, 0.0f, 1.0f),
+                                                  XMFLOAT3(0.0f, 1.0f, 0.0f), XMFLOAT3(0.0f, 1.0f, 0.0f)};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void MultiView::SetCubeFaces(const XMFLOAT3 &position, float z_near, float z_far) {
+    XMFLOAT4X4 projection;
+    XMStoreFloat4x4(&projection, XMMatrixPerspectiveFovLH(XM_PIDIV2, 1.0f, z_near, z_far));
+
+    auto eye = XMLoadFloat3(&position);
+    for (size_t i = 0; i != kCubeFaceDirections.size(); ++i) {
+        XMStoreFloat4x4(&_views[i], XMMatrixLookToLH(eye, XMLoadFloat3(&kCubeFaceDirections[i]),
+                                                     XMLoadFloat3(&kCubeFaceUps[i])));
+        _projections[i] = projection;
+        _constants.positions[i] = {position.x, position.y, position.z, z_far};
+    }
+
+    UpdateViews(static_cast<UINT>(kCubeFaceDirections.size()));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void MultiView::SetCascades(const Camera &camera, const XMFLOAT3 &light_direction, UINT count, float caster_distance,
+                            float lambda) {
+    assert(count <= kMaxViewCount && caster_distance >= 0.0f);
+
+    auto z_near = camera.GetNear();
+    auto z_far = camera.GetFar();
+    auto &inverse_view = camera.GetInverseView();
+    auto &inverse_projection = camera.GetInverseProjection();
+
+    // A corner of a split at the depth d is d * slope away from the view axis.
+    auto slope_squared = inverse_projection._11 * inverse_projection._11 +
+                         inverse_projection._22 * inverse_projection._22;
+
+    auto direction = XMVector3Normalize(XMLoadFloat3(&light_direction));
+    auto up = abs(XMVectorGetY(direction)) > 0.99f ? XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f) : kYAxisVector;
+    auto inverse_view_matrix = XMLoadFloat4x4(&inverse_view);
+
+    auto split_near = z_near;
+    for (UINT i = 0; i != count; ++i) {
+        auto ratio = static_cast<float>(i + 1) / static_cast<float>(count);
+        auto split_far = lambda * z_near * powf(z_far / z_near, ratio) +
+                         (1.0f - lambda) * (z_near + (z_far - z_near) * ratio);
+
+        // The center of the bounding sphere is on the view axis, where a near corner and a far corner are
+        // equally distant. It is clamped to the far plane when a split is too wide.
+        auto center_depth = std::min(0.5f * (split_near + split_far) * (1.0f + slope_squared), split_far);
+        auto far_offset = split_far - center_depth;
+        auto radius = sqrtf(far_offset * far_offset + split_far * split_far * slope_squared);
+        auto center = XMVector3TransformCoord(XMVectorSet(0.0f, 0.0f, center_depth, 1.0f), inverse_view_matrix);
+
+        // An eye is pulled back toward a light beyond the sphere, so casters between a light and a split
+        // aren't clipped by the near plane.
+        auto eye = XMVectorSubtract(center, XMVectorScale(direction, radius + caster_distance));
+
+        XMStoreFloat4x4(&_views[i], XMMatrixLookToLH(eye, direction, up));
+        XMStoreFloat4x4(&_projections[i], XMMatrixOrthographicLH(2.0f * radius, 2.0f * radius, 0.0f,
+                                                                 2.0f * radius + caster_distance));
+        XMStoreFloat4(&_constants.positions[i], XMVectorSetW(eye, split_far));
+        split_near = split_far;
+    }
+
+    UpdateViews(count);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void MultiView::SetStereo(const Camera &camera, float eye_separation) {
+    auto &inverse_view = camera.GetInverseView();
+    auto view = camera.GetView();
+    auto projection = camera.GetProjection();
+    auto position = camera.GetPosition();
+    auto right = XMFLOAT3(inverse_view._11, inverse_view._12, inverse_view._13);
+
+    for (UINT i = 0; i != 2; ++i) {
+        // Moving an eye to the left moves the scene to the right in the view space.
+        auto offset = (i == 0 ? 0.5f : -0.5f) * eye_separation;
+        XMStoreFloat4x4(&_views[i], XMMatrixMultiply(XMLoadFloat4x4(&view), XMMatrixTranslation(offset, 0.0f, 0.0f)));
+        _projections[i] = projection;
+        _constants.positions[i] = {position.x - right.x * offset, position.y - right.y * offset,
+                                   position.z - right.z * offset, camera.GetFar()};
+    }
+
+    UpdateViews(2);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void MultiView::UpdateViews(UINT count) {
+    for (UINT i = 0; i != count; ++i) {
+        XMStoreFloat4x4(&_constants.view_projections[i],
+                        XMMatrixMultiply(XMLoadFloat4x4(&_views[i]), XMLoadFloat4x4(&_projections[i])));
+        _frustums[i] = ExtractFrustum(_constants.view_projections[i]);
+    }
+
+    _constants.view_count = count;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
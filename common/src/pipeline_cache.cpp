@@ -0,0 +1,231 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include "pipeline_cache.h"
+
+#include <fmt/format.h>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include "utility.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+constexpr auto kPipelineLibraryName = "pipeline_library.bin";
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Read a whole file.
+//! \param path A file path.
+//! \return The contents of a file, or empty if a file isn't exist.
+std::vector<BYTE> ReadBinary(const std::filesystem::path &path) {
+    std::ifstream fin(path, std::ios::in | std::ios::binary);
+    if (!fin.is_open()) {
+        return {};
+    }
+
+    return {std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>()};
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Write a whole file. A file is written to a temporary file and then renamed, so a reader never sees a partial file.
+//! A cache is optional, so a failure is ignored.
+//! \param path A file path.
+//! \param header A header.
+//! \param header_size The size of a header.
+//! \param data Bytes.
+//! \param size The size of bytes.
+void WriteBinary(const std::filesystem::path &path, const void *header, size_t header_size,
+                 const void *data, size_t size) {
+    auto temp_path = path;
+    temp_path += ".tmp";
+
+    {
+        std::ofstream fout(temp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!fout.is_open()) {
+            return;
+        }
+
+        fout.write(static_cast<const char *>(header), static_cast<std::streamsize>(header_size));
+        fout.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+        if (!fout) {
+            fout.close();
+            std::error_code error_code;
+            std::filesystem::remove(temp_path, error_code);
+            return;
+        }
+    }
+
+    std::error_code error_code;
+    std::filesystem::rename(temp_path, path, error_code);
+    if (error_code) {
+        std::filesystem::remove(temp_path, error_code);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void WriteRootSignatureFile(const std::filesystem::path &path, UINT64 key, std::span<const BYTE> data) {
+    RootSignatureCacheHeader header = {kRootSignatureCacheMagic, kPipelineCacheVersion, key, data.size()};
+    WriteBinary(path, &header, sizeof(header), data.data(), data.size());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::vector<BYTE> ReadRootSignatureFile(const std::filesystem::path &path, UINT64 key) {
+    auto data = ReadBinary(path);
+    if (data.size() <= sizeof(RootSignatureCacheHeader)) {
+        return {};
+    }
+
+    RootSignatureCacheHeader header;
+    memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != kRootSignatureCacheMagic || header.version != kPipelineCacheVersion || header.key != key ||
+        header.size != data.size() - sizeof(header)) {
+        return {};
+    }
+
+    data.erase(data.begin(), data.begin() + sizeof(header));
+    return data;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+PipelineCache::PipelineCache(ID3D12Device *device, const std::filesystem::path &directory)
+        : _device(device), _directory(directory) {
+    // A cache is optional, so a failure only makes every load a miss.
+    std::error_code error_code;
+    std::filesystem::create_directories(_directory, error_code);
+
+    // A pipeline library isn't supported by old runtimes.
+    ComPtr<ID3D12Device1> device1;
+    if (FAILED(_device->QueryInterface(IID_PPV_ARGS(&device1)))) {
+        return;
+    }
+
+    // Data must be alive while a library is alive, because a library refers to it.
+    _library_data = ReadBinary(_directory / kPipelineLibraryName);
+    if (!_library_data.empty()) {
+        auto result = device1->CreatePipelineLibrary(_library_data.data(), _library_data.size(),
+                                                      IID_PPV_ARGS(&_library));
+        if (SUCCEEDED(result)) {
+            return;
+        }
+
+        // A library of another driver or adapter is discarded, and it is overwritten on save.
+        _library_data.clear();
+        _modified = true;
+    }
+
+    if (FAILED(device1->CreatePipelineLibrary(nullptr, 0, IID_PPV_ARGS(&_library)))) {
+        _library = nullptr;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+HRESULT PipelineCache::CreateRootSignature(const D3D12_ROOT_SIGNATURE_DESC &desc,
+                                           ID3D12RootSignature **root_signature) {
+    auto key = HashRootSignatureDesc(desc);
+    std::unique_lock lock(_mutex);
+    if (auto iter = _root_signatures.find(key); iter != _root_signatures.end()) {
+        return iter->second.CopyTo(root_signature);
+    }
+
+    // Create a root signature from a serialized root signature on disk.
+    ComPtr<ID3D12RootSignature> new_root_signature;
+    auto data = ReadRootSignatureFile(BuildPath(key), key);
+    if (!data.empty()) {
+        _device->CreateRootSignature(0, data.data(), data.size(), IID_PPV_ARGS(&new_root_signature));
+    }
+
+    // Serialize a root signature on a miss.
+    if (!new_root_signature) {
+        ComPtr<ID3DBlob> serialized_root_signature;
+        auto result = SerializeRootSignature(&desc, &serialized_root_signature);
+        if (FAILED(result)) {
+            return result;
+        }
+
+        result = _device->CreateRootSignature(0, serialized_root_signature->GetBufferPointer(),
+                                              serialized_root_signature->GetBufferSize(),
+                                              IID_PPV_ARGS(&new_root_signature));
+        if (FAILED(result)) {
+            return result;
+        }
+
+        WriteRootSignatureFile(BuildPath(key), key,
+                               {static_cast<const BYTE *>(serialized_root_signature->GetBufferPointer()),
+                                serialized_root_signature->GetBufferSize()});
+    }
+
+    // Root signatures are kept alive, so an address always identifies the same key.
+    _root_signatures.emplace(key, new_root_signature);
+    _root_signature_keys.emplace(new_root_signature.Get(), key);
+    *root_signature = new_root_signature.Detach();
+
+    return S_OK;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+HRESULT PipelineCache::CreateGraphicsPipelineState(const D3D12_GRAPHICS_PIPELINE_STATE_DESC &desc,
+                                                   ID3D12PipelineState **pipeline_state) {
+    std::unique_lock lock(_mutex);
+    auto iter = _root_signature_keys.find(desc.pRootSignature);
+    if (!_library || iter == _root_signature_keys.end()) {
+        lock.unlock();
+        return _device->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(pipeline_state));
+    }
+
+    // Load a pipeline state from the library. A name which isn't stored fails with E_INVALIDARG.
+    auto key = HashGraphicsPipelineDesc(desc, iter->second);
+    auto name = ConvertUTF8ToUTF16(fmt::format("{:016x}", key).c_str());
+    if (SUCCEEDED(_library->LoadGraphicsPipeline(name.c_str(), &desc, IID_PPV_ARGS(pipeline_state)))) {
+        return S_OK;
+    }
+
+    // Create a pipeline state without the lock, because it may take long.
+    lock.unlock();
+    auto result = _device->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(pipeline_state));
+    if (FAILED(result)) {
+        return result;
+    }
+
+    // A name which was stored by another thread meanwhile fails, and it is ignored.
+    lock.lock();
+    if (SUCCEEDED(_library->StorePipeline(name.c_str(), *pipeline_state))) {
+        _modified = true;
+    }
+
+    return result;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void PipelineCache::Save() {
+    if (!_library || !_modified) {
+        return;
+    }
+
+    std::vector<BYTE> data(_library->GetSerializedSize());
+    if (FAILED(_library->Serialize(data.data(), data.size()))) {
+        return;
+    }
+
+    // A library has its own header, so it is written as is.
+    WriteBinary(_directory / kPipelineLibraryName, nullptr, 0, data.data(), data.size());
+    _modified = false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::filesystem::path PipelineCache::BuildPath(UINT64 key) const {
+    return _directory / fmt::format("{:016x}.rootsig", key);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
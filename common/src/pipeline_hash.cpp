@@ -0,0 +1,201 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include "pipeline_hash.h"
+
+#include <cstring>
+#include <type_traits>
+
+#include "utility.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Accumulate a value to the FNV-1a hash. A value must have no padding, otherwise its key isn't stable.
+//! \param hash A hash.
+//! \param value A value.
+//! \return A hash.
+template<typename T>
+inline UINT64 HashValue(UINT64 hash, const T &value) {
+    static_assert(std::has_unique_object_representations_v<T> || std::is_floating_point_v<T>);
+    return HashBytes(hash, &value, sizeof(value));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Accumulate a string to the FNV-1a hash. A terminator is included, so concatenated strings don't collide.
+//! \param hash A hash.
+//! \param string A string, or null which is hashed as an empty string.
+//! \return A hash.
+inline UINT64 HashString(UINT64 hash, const char *string) {
+    auto size = string ? strlen(string) : 0;
+    hash = HashBytes(hash, string, size);
+    return HashBytes(hash, "", 1);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Accumulate the bytecode of a shader to the FNV-1a hash.
+//! \param hash A hash.
+//! \param bytecode The bytecode of a shader, which can be empty.
+//! \return A hash.
+inline UINT64 HashBytecode(UINT64 hash, const D3D12_SHADER_BYTECODE &bytecode) {
+    hash = HashValue(hash, static_cast<UINT64>(bytecode.BytecodeLength));
+    return HashBytes(hash, bytecode.pShaderBytecode, bytecode.BytecodeLength);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+UINT64 HashRootSignatureDesc(const D3D12_ROOT_SIGNATURE_DESC &desc) {
+    auto hash = HashValue(kHashOffsetBasis, kPipelineCacheVersion);
+
+    hash = HashValue(hash, desc.NumParameters);
+    for (UINT i = 0; i != desc.NumParameters; ++i) {
+        auto &parameter = desc.pParameters[i];
+        hash = HashValue(hash, parameter.ParameterType);
+        hash = HashValue(hash, parameter.ShaderVisibility);
+
+        // Only the active member of a union is hashed.
+        switch (parameter.ParameterType) {
+            case D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE: {
+                auto &table = parameter.DescriptorTable;
+                hash = HashValue(hash, table.NumDescriptorRanges);
+                for (UINT j = 0; j != table.NumDescriptorRanges; ++j) {
+                    hash = HashValue(hash, table.pDescriptorRanges[j]);
+                }
+                break;
+            }
+            case D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS:
+                hash = HashValue(hash, parameter.Constants);
+                break;
+            default:
+                hash = HashValue(hash, parameter.Descriptor);
+                break;
+        }
+    }
+
+    hash = HashValue(hash, desc.NumStaticSamplers);
+    for (UINT i = 0; i != desc.NumStaticSamplers; ++i) {
+        auto &sampler = desc.pStaticSamplers[i];
+        hash = HashValue(hash, sampler.Filter);
+        hash = HashValue(hash, sampler.AddressU);
+        hash = HashValue(hash, sampler.AddressV);
+        hash = HashValue(hash, sampler.AddressW);
+        hash = HashValue(hash, sampler.MipLODBias);
+        hash = HashValue(hash, sampler.MaxAnisotropy);
+        hash = HashValue(hash, sampler.ComparisonFunc);
+        hash = HashValue(hash, sampler.BorderColor);
+        hash = HashValue(hash, sampler.MinLOD);
+        hash = HashValue(hash, sampler.MaxLOD);
+        hash = HashValue(hash, sampler.ShaderRegister);
+        hash = HashValue(hash, sampler.RegisterSpace);
+        hash = HashValue(hash, sampler.ShaderVisibility);
+    }
+
+    return HashValue(hash, desc.Flags);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+UINT64 HashGraphicsPipelineDesc(const D3D12_GRAPHICS_PIPELINE_STATE_DESC &desc, UINT64 root_signature_key) {
+    auto hash = HashValue(kHashOffsetBasis, kPipelineCacheVersion);
+    hash = HashValue(hash, root_signature_key);
+
+    // Hash shaders.
+    hash = HashBytecode(hash, desc.VS);
+    hash = HashBytecode(hash, desc.PS);
+    hash = HashBytecode(hash, desc.DS);
+    hash = HashBytecode(hash, desc.HS);
+    hash = HashBytecode(hash, desc.GS);
+
+    // Hash a stream output.
+    auto &stream_output = desc.StreamOutput;
+    hash = HashValue(hash, stream_output.NumEntries);
+    for (UINT i = 0; i != stream_output.NumEntries; ++i) {
+        auto &entry = stream_output.pSODeclaration[i];
+        hash = HashValue(hash, entry.Stream);
+        hash = HashString(hash, entry.SemanticName);
+        hash = HashValue(hash, entry.SemanticIndex);
+        hash = HashValue(hash, entry.StartComponent);
+        hash = HashValue(hash, entry.ComponentCount);
+        hash = HashValue(hash, entry.OutputSlot);
+    }
+    hash = HashValue(hash, stream_output.NumStrides);
+    for (UINT i = 0; i != stream_output.NumStrides; ++i) {
+        hash = HashValue(hash, stream_output.pBufferStrides[i]);
+    }
+    hash = HashValue(hash, stream_output.RasterizedStream);
+
+    // Hash a blend state.
+    auto &blend_state = desc.BlendState;
+    hash = HashValue(hash, blend_state.AlphaToCoverageEnable);
+    hash = HashValue(hash, blend_state.IndependentBlendEnable);
+    for (auto &render_target : blend_state.RenderTarget) {
+        hash = HashValue(hash, render_target.BlendEnable);
+        hash = HashValue(hash, render_target.LogicOpEnable);
+        hash = HashValue(hash, render_target.SrcBlend);
+        hash = HashValue(hash, render_target.DestBlend);
+        hash = HashValue(hash, render_target.BlendOp);
+        hash = HashValue(hash, render_target.SrcBlendAlpha);
+        hash = HashValue(hash, render_target.DestBlendAlpha);
+        hash = HashValue(hash, render_target.BlendOpAlpha);
+        hash = HashValue(hash, render_target.LogicOp);
+        hash = HashValue(hash, render_target.RenderTargetWriteMask);
+    }
+    hash = HashValue(hash, desc.SampleMask);
+
+    // Hash a rasterizer state.
+    auto &rasterizer_state = desc.RasterizerState;
+    hash = HashValue(hash, rasterizer_state.FillMode);
+    hash = HashValue(hash, rasterizer_state.CullMode);
+    hash = HashValue(hash, rasterizer_state.FrontCounterClockwise);
+    hash = HashValue(hash, rasterizer_state.DepthBias);
+    hash = HashValue(hash, rasterizer_state.DepthBiasClamp);
+    hash = HashValue(hash, rasterizer_state.SlopeScaledDepthBias);
+    hash = HashValue(hash, rasterizer_state.DepthClipEnable);
+    hash = HashValue(hash, rasterizer_state.MultisampleEnable);
+    hash = HashValue(hash, rasterizer_state.AntialiasedLineEnable);
+    hash = HashValue(hash, rasterizer_state.ForcedSampleCount);
+    hash = HashValue(hash, rasterizer_state.ConservativeRaster);
+
+    // Hash a depth stencil state.
+    auto &depth_stencil_state = desc.DepthStencilState;
+    hash = HashValue(hash, depth_stencil_state.DepthEnable);
+    hash = HashValue(hash, depth_stencil_state.DepthWriteMask);
+    hash = HashValue(hash, depth_stencil_state.DepthFunc);
+    hash = HashValue(hash, depth_stencil_state.StencilEnable);
+    hash = HashValue(hash, depth_stencil_state.StencilReadMask);
+    hash = HashValue(hash, depth_stencil_state.StencilWriteMask);
+    hash = HashValue(hash, depth_stencil_state.FrontFace);
+    hash = HashValue(hash, depth_stencil_state.BackFace);
+
+    // Hash an input layout. Semantic names are hashed by their contents.
+    auto &input_layout = desc.InputLayout;
+    hash = HashValue(hash, input_layout.NumElements);
+    for (UINT i = 0; i != input_layout.NumElements; ++i) {
+        auto &element = input_layout.pInputElementDescs[i];
+        hash = HashString(hash, element.SemanticName);
+        hash = HashValue(hash, element.SemanticIndex);
+        hash = HashValue(hash, element.Format);
+        hash = HashValue(hash, element.InputSlot);
+        hash = HashValue(hash, element.AlignedByteOffset);
+        hash = HashValue(hash, element.InputSlotClass);
+        hash = HashValue(hash, element.InstanceDataStepRate);
+    }
+
+    // Hash output formats and others. A cached blob isn't hashed, because it doesn't change a pipeline state.
+    hash = HashValue(hash, desc.IBStripCutValue);
+    hash = HashValue(hash, desc.PrimitiveTopologyType);
+    hash = HashValue(hash, desc.NumRenderTargets);
+    for (auto format : desc.RTVFormats) {
+        hash = HashValue(hash, format);
+    }
+    hash = HashValue(hash, desc.DSVFormat);
+    hash = HashValue(hash, desc.SampleDesc);
+    hash = HashValue(hash, desc.NodeMask);
+
+    return HashValue(hash, desc.Flags);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
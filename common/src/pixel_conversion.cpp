@@ -0,0 +1,560 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include "pixel_conversion.h"
+
+#include <DirectXMath.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#include <immintrin.h>
+#endif
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// MSVC compiles intrinsics of any instruction set, while GCC and Clang compile them in functions which target it.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define PIXEL_TARGET(instruction_set)
+#else
+#define PIXEL_TARGET(instruction_set) __attribute__((target(instruction_set)))
+#endif
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Multiply two 8 bit unsigned normalized values. The result is exactly round(lhs * rhs / 255).
+//! \param lhs A value.
+//! \param rhs A value.
+//! \return The product.
+inline BYTE MultiplyUNorm(UINT lhs, UINT rhs) {
+    auto product = lhs * rhs + 128;
+    return static_cast<BYTE>((product + (product >> 8)) >> 8);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Convert a float to a half float. It rounds to nearest even like F16C and NEON, including subnormals,
+//! so the scalar path gives the same bits as the vectorized paths.
+//! \param value A float.
+//! \return A half float.
+inline UINT16 ConvertFloatToHalf(float value) {
+    UINT32 bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    auto sign = static_cast<UINT16>((bits >> 16) & 0x8000);
+    auto magnitude = bits & 0x7FFFFFFF;
+
+    // NaN is quiet and keeps the upper bits of the payload.
+    if (magnitude > 0x7F800000) {
+        return sign | 0x7E00 | ((magnitude >> 13) & 0x3FF);
+    }
+
+    // Values from 65520 round to infinity.
+    if (magnitude >= 0x477FF000) {
+        return sign | 0x7C00;
+    }
+
+    // Values under 2^-14 become subnormal half floats and values up to 2^-25 become zero.
+    UINT32 half, remainder, halfway;
+    if (magnitude < 0x38800000) {
+        if (magnitude <= 0x33000000) {
+            return sign;
+        }
+
+        auto shift = 126 - (magnitude >> 23);
+        auto mantissa = (magnitude & 0x7FFFFF) | 0x800000;
+        half = mantissa >> shift;
+        remainder = mantissa & ((1 << shift) - 1);
+        halfway = 1 << (shift - 1);
+    } else {
+        half = (magnitude - 0x38000000) >> 13;
+        remainder = magnitude & 0x1FFF;
+        halfway = 0x1000;
+    }
+
+    // Round to nearest even. A carry to the exponent is the correct result.
+    if (remainder > halfway || (remainder == halfway && (half & 1))) {
+        ++half;
+    }
+
+    return sign | static_cast<UINT16>(half);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Build a table which converts from 8 bit values to half floats.
+//! All paths share this table, so conversions of 8 bit values are bit exact on every platform.
+//! \param srgb Whether values are in sRGB color space or not.
+//! \return A table.
+auto BuildHalfTable(bool srgb) {
+    std::array<UINT16, 256> table = {};
+    for (auto i = 0; i != 256; ++i) {
+        auto value = i / 255.0f;
+        if (srgb) {
+            value = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+        }
+        table[i] = ConvertFloatToHalf(value);
+    }
+    return table;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static const auto kUNormToHalfTable = BuildHalfTable(false);
+static const auto kSRGBToHalfTable = BuildHalfTable(true);
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Convert a float to a small unsigned float which has 5 exponent bits like a half float and fewer mantissa bits.
+//! It rounds from the bits of a float once, because rounding to a half float first rounds twice.
+//! \param value A float.
+//! \param mantissa_bits The number of mantissa bits, which is 6 for 11 bit floats and 5 for 10 bit floats.
+//! \return A small float.
+inline UINT32 ConvertFloatToSmallFloat(float value, UINT32 mantissa_bits) {
+    UINT32 bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    // The format is unsigned, so negative values become zero.
+    if (bits & 0x80000000) {
+        return 0;
+    }
+
+    // Keep infinity, and NaN keeps the upper bits of the payload.
+    auto shift = 23 - mantissa_bits;
+    auto infinity = 0x1Fu << mantissa_bits;
+    if (bits >= 0x7F800000) {
+        return bits == 0x7F800000 ? infinity : infinity | ((bits & 0x7FFFFF) >> shift) | 1;
+    }
+
+    // Values from the halfway between the largest value and 2^16 round to infinity.
+    if (bits >= 0x47000000 + (((1u << (mantissa_bits + 1)) - 1) << (shift - 1))) {
+        return infinity;
+    }
+
+    // Values under 2^-14 become subnormal small floats and values up to the half of the smallest one become zero.
+    UINT32 small, remainder, halfway;
+    if (bits < 0x38800000) {
+        auto subnormal_shift = 113 - (bits >> 23) + shift;
+        if (subnormal_shift > 24) {
+            return 0;
+        }
+
+        auto mantissa = (bits & 0x7FFFFF) | 0x800000;
+        small = mantissa >> subnormal_shift;
+        remainder = mantissa & ((1 << subnormal_shift) - 1);
+        halfway = 1 << (subnormal_shift - 1);
+    } else {
+        small = (bits - 0x38000000) >> shift;
+        remainder = bits & ((1 << shift) - 1);
+        halfway = 1 << (shift - 1);
+    }
+
+    // Round to nearest even. A carry to the exponent is the correct result.
+    if (remainder > halfway || (remainder == halfway && (small & 1))) {
+        ++small;
+    }
+
+    return small;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Find the fastest path which a CPU supports.
+//! \return A path.
+PixelConversionPath FindSupportedPath() {
+#if defined(_M_X64) || defined(__x86_64__)
+    auto read_cpuid = [](UINT32 leaf, UINT32 (&registers)[4]) {
+#ifdef _MSC_VER
+        __cpuidex(reinterpret_cast<int *>(registers), static_cast<int>(leaf), 0);
+#else
+        __cpuid_count(leaf, 0, registers[0], registers[1], registers[2], registers[3]);
+#endif
+    };
+
+    UINT32 registers[4];
+    read_cpuid(0, registers);
+    auto max_leaf = registers[0];
+
+    read_cpuid(1, registers);
+    auto features = registers[2];
+    if (!(features & (1 << 19))) {
+        return PixelConversionPath::kScalar;
+    }
+
+    // AVX2 needs an OS which saves YMM registers, and half float conversions need F16C.
+    constexpr UINT32 kAVXFeatures = (1 << 27) | (1 << 28) | (1 << 29);
+    if ((features & kAVXFeatures) != kAVXFeatures || max_leaf < 7) {
+        return PixelConversionPath::kSSE4;
+    }
+
+#ifdef _MSC_VER
+    auto xcr0 = _xgetbv(0);
+#else
+    UINT32 xcr0_lo, xcr0_hi;
+    __asm__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+    auto xcr0 = (static_cast<UINT64>(xcr0_hi) << 32) | xcr0_lo;
+#endif
+    read_cpuid(7, registers);
+    if ((xcr0 & 0x6) != 0x6 || !(registers[1] & (1 << 5))) {
+        return PixelConversionPath::kSSE4;
+    }
+
+    return PixelConversionPath::kAVX2;
+#elif defined(_XM_ARM_NEON_INTRINSICS_)
+    return PixelConversionPath::kNEON;
+#else
+    return PixelConversionPath::kScalar;
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static const auto kSupportedPath = FindSupportedPath();
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Retrieve the path which conversions use. It is the fastest supported path unless a test limits it.
+//! \return A path.
+std::atomic<PixelConversionPath> &GetSelectedPath() {
+    static std::atomic<PixelConversionPath> path = FindSupportedPath();
+    return path;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#if defined(_M_X64) || defined(__x86_64__)
+
+//! Expand RGB8 pixels to RGBA8 pixels with SSSE3 shuffles. A tail is left to the scalar path.
+//! \param src RGB8 pixels.
+//! \param dst RGBA8 pixels.
+//! \param count The number of pixels.
+//! \return The number of converted pixels.
+PIXEL_TARGET("sse4.1")
+size_t ConvertRGBToRGBASSE4(const BYTE *src, BYTE *dst, size_t count) {
+    // Expand 4 pixels per iteration. 16 bytes are loaded to read 12 bytes, so stop before over reading.
+    const auto shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const auto alpha = _mm_set1_epi32(0xFF000000);
+    size_t i = 0;
+    for (; i + 6 <= count; i += 4) {
+        auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 3));
+        pixels = _mm_or_si128(_mm_shuffle_epi8(pixels, shuffle), alpha);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4), pixels);
+    }
+    return i;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Swap red and blue of RGBA8 pixels with SSSE3 shuffles. A tail is left to the scalar path.
+//! \param src RGBA8 or BGRA8 pixels.
+//! \param dst BGRA8 or RGBA8 pixels.
+//! \param count The number of pixels.
+//! \return The number of converted pixels.
+PIXEL_TARGET("sse4.1")
+size_t SwizzleRedBlueSSE4(const BYTE *src, BYTE *dst, size_t count) {
+    // Swizzle 4 pixels per iteration.
+    const auto shuffle = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4), _mm_shuffle_epi8(pixels, shuffle));
+    }
+    return i;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Swap red and blue of RGBA8 pixels with AVX2 shuffles. A tail is left to the scalar path.
+//! \param src RGBA8 or BGRA8 pixels.
+//! \param dst BGRA8 or RGBA8 pixels.
+//! \param count The number of pixels.
+//! \return The number of converted pixels.
+PIXEL_TARGET("avx2")
+size_t SwizzleRedBlueAVX2(const BYTE *src, BYTE *dst, size_t count) {
+    // Swizzle 8 pixels per iteration.
+    const auto shuffle = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                                          2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        auto pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i * 4));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i * 4), _mm256_shuffle_epi8(pixels, shuffle));
+    }
+    return i;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Multiply 16 bit colors by alpha of each pixel. Alpha is multiplied by 255, so it is unchanged.
+//! \param colors Colors of 2 pixels which are widened to 16 bits.
+//! \return Premultiplied colors.
+PIXEL_TARGET("sse4.1")
+inline __m128i MultiplyAlphaSSE4(__m128i colors) {
+    auto alphas = _mm_shufflehi_epi16(_mm_shufflelo_epi16(colors, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    auto product = _mm_add_epi16(_mm_mullo_epi16(colors, _mm_blend_epi16(alphas, _mm_set1_epi16(255), 0x88)),
+                                 _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(product, _mm_srli_epi16(product, 8)), 8);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Multiply color by alpha of RGBA8 pixels with SSE4.1. A tail is left to the scalar path.
+//! \param src RGBA8 pixels.
+//! \param dst Premultiplied RGBA8 pixels.
+//! \param count The number of pixels.
+//! \return The number of converted pixels.
+PIXEL_TARGET("sse4.1")
+size_t PremultiplyAlphaSSE4(const BYTE *src, BYTE *dst, size_t count) {
+    // Premultiply 4 pixels per iteration.
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 4));
+        auto lo = MultiplyAlphaSSE4(_mm_cvtepu8_epi16(pixels));
+        auto hi = MultiplyAlphaSSE4(_mm_cvtepu8_epi16(_mm_srli_si128(pixels, 8)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4), _mm_packus_epi16(lo, hi));
+    }
+    return i;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Multiply 16 bit colors by alpha of each pixel. Alpha is multiplied by 255, so it is unchanged.
+//! \param colors Colors of 4 pixels which are widened to 16 bits.
+//! \return Premultiplied colors.
+PIXEL_TARGET("avx2")
+inline __m256i MultiplyAlphaAVX2(__m256i colors) {
+    auto alphas = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(colors, _MM_SHUFFLE(3, 3, 3, 3)),
+                                         _MM_SHUFFLE(3, 3, 3, 3));
+    auto product = _mm256_add_epi16(_mm256_mullo_epi16(colors, _mm256_blend_epi16(alphas, _mm256_set1_epi16(255),
+                                                                                  0x88)),
+                                    _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(product, _mm256_srli_epi16(product, 8)), 8);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Multiply color by alpha of RGBA8 pixels with AVX2. A tail is left to the scalar path.
+//! \param src RGBA8 pixels.
+//! \param dst Premultiplied RGBA8 pixels.
+//! \param count The number of pixels.
+//! \return The number of converted pixels.
+PIXEL_TARGET("avx2")
+size_t PremultiplyAlphaAVX2(const BYTE *src, BYTE *dst, size_t count) {
+    // Premultiply 8 pixels per iteration.
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        auto pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i * 4));
+        auto lo = MultiplyAlphaAVX2(_mm256_cvtepu8_epi16(_mm256_castsi256_si128(pixels)));
+        auto hi = MultiplyAlphaAVX2(_mm256_cvtepu8_epi16(_mm256_extracti128_si256(pixels, 1)));
+        // Packing works in each 128 bit lane, so restore the order of pixels.
+        pixels = _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i * 4), pixels);
+    }
+    return i;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Convert from float components to half float components with F16C. A tail is left to the scalar path.
+//! \param src Float components.
+//! \param dst Half float components.
+//! \param count The number of components.
+//! \return The number of converted components.
+PIXEL_TARGET("avx2,f16c")
+size_t ConvertFloatToHalfF16C(const float *src, UINT16 *dst, size_t count) {
+    // Convert 8 components per iteration.
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        auto halves = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), halves);
+    }
+    return i;
+}
+
+#endif
+
+//----------------------------------------------------------------------------------------------------------------------
+
+PixelConversionPath GetPixelConversionPath() {
+    return GetSelectedPath().load(std::memory_order_relaxed);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+PixelConversionPath SetPixelConversionPath(PixelConversionPath path) {
+    // x86 paths are ordered by features, so an unsupported path is lowered to the fastest supported one.
+    if (kSupportedPath == PixelConversionPath::kNEON) {
+        path = path == PixelConversionPath::kNEON ? path : PixelConversionPath::kScalar;
+    } else {
+        path = std::min(path, kSupportedPath);
+    }
+
+    GetSelectedPath().store(path, std::memory_order_relaxed);
+    return path;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void ConvertRGBToRGBA(const BYTE *src, BYTE *dst, size_t count) {
+    size_t i = 0;
+    auto path = GetPixelConversionPath();
+
+#if defined(_M_X64) || defined(__x86_64__)
+    if (path >= PixelConversionPath::kSSE4) {
+        i = ConvertRGBToRGBASSE4(src, dst, count);
+    }
+#elif defined(_XM_ARM_NEON_INTRINSICS_)
+    if (path == PixelConversionPath::kNEON) {
+        // Expand 16 pixels per iteration.
+        for (; i + 16 <= count; i += 16) {
+            auto rgb = vld3q_u8(src + i * 3);
+            uint8x16x4_t rgba = {rgb.val[0], rgb.val[1], rgb.val[2], vdupq_n_u8(255)};
+            vst4q_u8(dst + i * 4, rgba);
+        }
+    }
+#endif
+
+    for (; i != count; ++i) {
+        dst[i * 4 + 0] = src[i * 3 + 0];
+        dst[i * 4 + 1] = src[i * 3 + 1];
+        dst[i * 4 + 2] = src[i * 3 + 2];
+        dst[i * 4 + 3] = 255;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void SwizzleRedBlue(const BYTE *src, BYTE *dst, size_t count) {
+    size_t i = 0;
+    auto path = GetPixelConversionPath();
+
+#if defined(_M_X64) || defined(__x86_64__)
+    if (path == PixelConversionPath::kAVX2) {
+        i = SwizzleRedBlueAVX2(src, dst, count);
+    } else if (path == PixelConversionPath::kSSE4) {
+        i = SwizzleRedBlueSSE4(src, dst, count);
+    }
+#elif defined(_XM_ARM_NEON_INTRINSICS_)
+    if (path == PixelConversionPath::kNEON) {
+        // Swizzle 16 pixels per iteration.
+        for (; i + 16 <= count; i += 16) {
+            auto pixels = vld4q_u8(src + i * 4);
+            std::swap(pixels.val[0], pixels.val[2]);
+            vst4q_u8(dst + i * 4, pixels);
+        }
+    }
+#endif
+
+    for (; i != count; ++i) {
+        auto red = src[i * 4 + 0];
+        dst[i * 4 + 0] = src[i * 4 + 2];
+        dst[i * 4 + 1] = src[i * 4 + 1];
+        dst[i * 4 + 2] = red;
+        dst[i * 4 + 3] = src[i * 4 + 3];
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void PremultiplyAlpha(const BYTE *src, BYTE *dst, size_t count) {
+    size_t i = 0;
+    auto path = GetPixelConversionPath();
+
+#if defined(_M_X64) || defined(__x86_64__)
+    if (path == PixelConversionPath::kAVX2) {
+        i = PremultiplyAlphaAVX2(src, dst, count);
+    } else if (path == PixelConversionPath::kSSE4) {
+        i = PremultiplyAlphaSSE4(src, dst, count);
+    }
+#elif defined(_XM_ARM_NEON_INTRINSICS_)
+    if (path == PixelConversionPath::kNEON) {
+        // Premultiply 16 pixels per iteration.
+        auto multiply = [](uint8x8_t colors, uint8x8_t alphas) {
+            auto product = vaddq_u16(vmull_u8(colors, alphas), vdupq_n_u16(128));
+            return vshrn_n_u16(vaddq_u16(product, vshrq_n_u16(product, 8)), 8);
+        };
+        for (; i + 16 <= count; i += 16) {
+            auto pixels = vld4q_u8(src + i * 4);
+            for (auto c = 0; c != 3; ++c) {
+                pixels.val[c] = vcombine_u8(multiply(vget_low_u8(pixels.val[c]), vget_low_u8(pixels.val[3])),
+                                            multiply(vget_high_u8(pixels.val[c]), vget_high_u8(pixels.val[3])));
+            }
+            vst4q_u8(dst + i * 4, pixels);
+        }
+    }
+#endif
+
+    for (; i != count; ++i) {
+        auto alpha = src[i * 4 + 3];
+        dst[i * 4 + 0] = MultiplyUNorm(src[i * 4 + 0], alpha);
+        dst[i * 4 + 1] = MultiplyUNorm(src[i * 4 + 1], alpha);
+        dst[i * 4 + 2] = MultiplyUNorm(src[i * 4 + 2], alpha);
+        dst[i * 4 + 3] = alpha;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void ConvertUNormToHalf(const BYTE *src, UINT16 *dst, size_t count) {
+    // A table lookup is exact and faster than the arithmetic for 8 bit inputs.
+    for (size_t i = 0; i != count; ++i) {
+        dst[i] = kUNormToHalfTable[src[i]];
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void ConvertSRGBToLinearHalf(const BYTE *src, UINT16 *dst, size_t count) {
+    for (size_t i = 0; i != count; ++i) {
+        dst[i * 4 + 0] = kSRGBToHalfTable[src[i * 4 + 0]];
+        dst[i * 4 + 1] = kSRGBToHalfTable[src[i * 4 + 1]];
+        dst[i * 4 + 2] = kSRGBToHalfTable[src[i * 4 + 2]];
+        dst[i * 4 + 3] = kUNormToHalfTable[src[i * 4 + 3]];
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void ConvertFloatToHalf(const float *src, UINT16 *dst, size_t count) {
+    size_t i = 0;
+    auto path = GetPixelConversionPath();
+
+#if defined(_M_X64) || defined(__x86_64__)
+    if (path == PixelConversionPath::kAVX2) {
+        i = ConvertFloatToHalfF16C(src, dst, count);
+    }
+#elif defined(_XM_ARM_NEON_INTRINSICS_) && (defined(_M_ARM64) || defined(__aarch64__))
+    if (path == PixelConversionPath::kNEON) {
+        // Convert 4 components per iteration.
+        for (; i + 4 <= count; i += 4) {
+            vst1_u16(dst + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(src + i))));
+        }
+    }
+#endif
+
+    for (; i != count; ++i) {
+        dst[i] = ConvertFloatToHalf(src[i]);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void ConvertFloatToR11G11B10(const float *src, UINT32 *dst, size_t count) {
+    for (size_t i = 0; i != count; ++i) {
+        dst[i] = (ConvertFloatToSmallFloat(src[i * 4 + 0], 6) << 0) |
+                 (ConvertFloatToSmallFloat(src[i * 4 + 1], 6) << 11) |
+                 (ConvertFloatToSmallFloat(src[i * 4 + 2], 5) << 22);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,267 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include "profiler.h"
+
+#include <fmt/format.h>
+#include <imgui.h>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+ProfileBuffer::ProfileBuffer(UINT32 thread, std::string name)
+        : _slots(std::make_unique<Slot[]>(kProfileBufferCapacity)), _thread(thread), _name(std::move(name)) {
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void ProfileBuffer::Read(std::vector<ProfileEvent> *events) {
+    auto write_index = _write_index.load(std::memory_order_acquire);
+    auto begin_index = std::max(_read_index, write_index > kProfileBufferCapacity ?
+                                             write_index - kProfileBufferCapacity : 0);
+    auto offset = events->size();
+    for (auto i = begin_index; i != write_index; ++i) {
+        auto &slot = _slots[i & (kProfileBufferCapacity - 1)];
+        events->push_back({slot.name.load(std::memory_order_relaxed), slot.begin.load(std::memory_order_relaxed),
+                           slot.end.load(std::memory_order_relaxed), _thread,
+                           slot.depth.load(std::memory_order_relaxed)});
+    }
+
+    // Drop events whose slots were claimed by a writer while they were read.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    auto claim_index = _claim_index.load(std::memory_order_relaxed);
+    if (claim_index > begin_index + kProfileBufferCapacity) {
+        auto count = std::min(claim_index - begin_index - kProfileBufferCapacity, write_index - begin_index);
+        events->erase(events->begin() + static_cast<ptrdiff_t>(offset),
+                      events->begin() + static_cast<ptrdiff_t>(offset + count));
+    }
+
+    _read_index = write_index;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void ProfileBuffer::SetName(std::string name) {
+    std::lock_guard lock(_name_mutex);
+    _name = std::move(name);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::string ProfileBuffer::GetName() const {
+    std::lock_guard lock(_name_mutex);
+    return _name;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Profiler *Profiler::GetInstance() {
+    static std::unique_ptr<Profiler> profiler(new Profiler());
+    return profiler.get();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Profiler::SetThreadName(std::string name) {
+    GetThreadBuffer()->SetName(std::move(name));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Profiler::EndFrame() {
+    std::vector<ProfileEvent> frame_events;
+    _frame.clear();
+    UpdateTickPeriod();
+
+    std::lock_guard lock(_mutex);
+    for (auto &buffer : _buffers) {
+        _events.clear();
+        buffer->Read(&_events);
+        if (_events.empty()) {
+            continue;
+        }
+
+        // A zone is written when it is left, so a parent is written after its children.
+        std::sort(_events.begin(), _events.end(), [](const auto &lhs, const auto &rhs) {
+            return lhs.begin != rhs.begin ? lhs.begin < rhs.begin : lhs.depth < rhs.depth;
+        });
+        Aggregate(*buffer, _events);
+        frame_events.insert(frame_events.end(), _events.begin(), _events.end());
+    }
+
+    _history.push_back(std::move(frame_events));
+    if (_history.size() > kProfileHistoryFrameCount) {
+        _history.pop_front();
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Profiler::DrawImGui() const {
+    UINT32 open_depth = 0;
+    for (size_t i = 0; i != _frame.size(); ++i) {
+        auto &node = _frame[i];
+
+        // Children of a closed node are skipped.
+        if (node.depth > open_depth) {
+            continue;
+        }
+
+        while (open_depth > node.depth) {
+            ImGui::TreePop();
+            --open_depth;
+        }
+
+        auto is_leaf = i + 1 == _frame.size() || _frame[i + 1].depth <= node.depth;
+        auto flags = is_leaf ? ImGuiTreeNodeFlags_Leaf : ImGuiTreeNodeFlags_DefaultOpen;
+        if (ImGui::TreeNodeEx(node.name.c_str(), flags, "%s: %.3f ms (%u)", node.name.c_str(),
+                              static_cast<double>(node.time) / 1000000.0, node.count)) {
+            ++open_depth;
+        }
+    }
+
+    while (open_depth > 0) {
+        ImGui::TreePop();
+        --open_depth;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Profiler::ExportChromeTrace(const std::filesystem::path &path) const {
+    auto events = nlohmann::json::array();
+
+    {
+        std::lock_guard lock(_mutex);
+        for (auto &buffer : _buffers) {
+            events.push_back({{"name", "thread_name"}, {"ph", "M"}, {"pid", 0}, {"tid", buffer->GetThread()},
+                              {"args", {{"name", buffer->GetName()}}}});
+        }
+    }
+
+    // Timestamps and durations are microseconds.
+    for (auto &frame_events : _history) {
+        for (auto &event : frame_events) {
+            events.push_back({{"name", event.name}, {"ph", "X"}, {"pid", 0}, {"tid", event.thread},
+                              {"ts", ToNanoseconds(event.begin - _epoch) / 1000.0},
+                              {"dur", ToNanoseconds(event.end - event.begin) / 1000.0}});
+        }
+    }
+
+    std::ofstream fout(path, std::ios::out | std::ios::trunc);
+    if (!fout.is_open()) {
+        throw std::runtime_error(fmt::format("Fail to open {}.", path.string()));
+    }
+
+    fout << nlohmann::json({{"traceEvents", events}, {"displayTimeUnit", "ns"}}).dump();
+    if (!fout) {
+        throw std::runtime_error(fmt::format("Fail to write {}.", path.string()));
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Profiler::Profiler()
+        : _epoch(Now()), _clock_epoch(GetClockTime()) {
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Profiler::UpdateTickPeriod() {
+    // A period gets more accurate as time goes by, so it is measured over the whole run.
+    auto ticks = Now() - _epoch;
+    auto time = GetClockTime() - _clock_epoch;
+    if (ticks != 0 && time != 0) {
+        _tick_period = static_cast<double>(time) / static_cast<double>(ticks);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+ProfileBuffer *Profiler::RegisterThread() {
+    std::lock_guard lock(_mutex);
+    auto thread = static_cast<UINT32>(_buffers.size());
+    _buffers.push_back(std::make_unique<ProfileBuffer>(thread, fmt::format("Thread {}", thread)));
+    return _buffers.back().get();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Profiler::Aggregate(const ProfileBuffer &buffer, std::span<ProfileEvent> events) {
+    constexpr UINT32 kNoNode = UINT32_MAX;
+
+    struct TreeNode {
+        const char *name;
+        UINT64 time;
+        UINT32 count;
+        UINT32 first_child;
+        UINT32 last_child;
+        UINT32 next_sibling;
+    };
+
+    // Zones which have the same path are merged. A zone whose parent isn't collected yet is attached to
+    // the deepest known ancestor, which is a zone that contains it in time, so never to a sibling which has ended.
+    std::vector<TreeNode> nodes = {{nullptr, 0, 0, kNoNode, kNoNode, kNoNode}};
+    std::vector<std::pair<UINT32, UINT64>> parents;
+    for (auto &event : events) {
+        parents.resize(std::min<size_t>(event.depth, parents.size()));
+        while (!parents.empty() && parents.back().second < event.end) {
+            parents.pop_back();
+        }
+        auto parent = parents.empty() ? 0 : parents.back().first;
+
+        auto child = nodes[parent].first_child;
+        while (child != kNoNode && strcmp(nodes[child].name, event.name) != 0) {
+            child = nodes[child].next_sibling;
+        }
+
+        if (child == kNoNode) {
+            child = static_cast<UINT32>(nodes.size());
+            nodes.push_back({event.name, 0, 0, kNoNode, kNoNode, kNoNode});
+            if (nodes[parent].first_child == kNoNode) {
+                nodes[parent].first_child = child;
+            } else {
+                nodes[nodes[parent].last_child].next_sibling = child;
+            }
+            nodes[parent].last_child = child;
+        }
+
+        nodes[child].time += event.end - event.begin;
+        ++nodes[child].count;
+        if (parent == 0) {
+            nodes[0].time += event.end - event.begin;
+        }
+        parents.emplace_back(child, event.end);
+    }
+
+    // Flatten a tree in the pre-order, and the root becomes the node of a thread.
+    _frame.push_back({buffer.GetName(), 0, 1, static_cast<UINT64>(ToNanoseconds(nodes[0].time))});
+    std::vector<std::pair<UINT32, UINT32>> stack;
+    for (auto child = nodes[0].first_child; child != kNoNode; child = nodes[child].next_sibling) {
+        stack.emplace_back(child, 1);
+    }
+    std::reverse(stack.begin(), stack.end());
+
+    while (!stack.empty()) {
+        auto [index, depth] = stack.back();
+        stack.pop_back();
+
+        auto &node = nodes[index];
+        _frame.push_back({node.name, depth, node.count, static_cast<UINT64>(ToNanoseconds(node.time))});
+
+        auto size = stack.size();
+        for (auto child = node.first_child; child != kNoNode; child = nodes[child].next_sibling) {
+            stack.emplace_back(child, depth + 1);
+        }
+        std::reverse(stack.begin() + static_cast<ptrdiff_t>(size), stack.end());
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -11,6 +11,7 @@
 #include <algorithm>
 
 #include "utility.h"
+#include "image_loader.h"
 
 #ifdef __clang__
 #pragma clang diagnostic push
@@ -62,13 +63,21 @@ void ResourceUploader::RecordCopyData(ID3D12Resource *buffer, void *data, UINT64
 }
 
 void ResourceUploader::RecordCopyData(ID3D12Resource *buffer, UINT mip_slice, const void *data, UINT64 size) {
+    RecordCopyData(buffer, mip_slice, 0, data, size);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void ResourceUploader::RecordCopyData(ID3D12Resource *buffer, UINT mip_slice, UINT array_slice, const void *data,
+                                      UINT64 size) {
     // Retrieve information to create an upload buffer.
     auto desc = buffer->GetDesc();
+    auto subresource = D3D12CalcSubresource(mip_slice, array_slice, 0, desc.MipLevels, desc.DepthOrArraySize);
     D3D12_PLACED_SUBRESOURCE_FOOTPRINT layout;
     UINT height;
     UINT64 row_pitch;
     UINT64 required_size;
-    _device->GetCopyableFootprints(&desc, mip_slice, 1, 0, &layout, &height, &row_pitch, &required_size);
+    _device->GetCopyableFootprints(&desc, subresource, 1, 0, &layout, &height, &row_pitch, &required_size);
 
     // Create an upload buffer.
     ComPtr<ID3D12Resource> upload_buffer;
@@ -84,7 +93,6 @@ void ResourceUploader::RecordCopyData(ID3D12Resource *buffer, UINT mip_slice, co
     copy_desc.SlicePitch = copy_desc.RowPitch * height;
 
     // Record commands.
-    auto subresource = D3D12CalcSubresource(mip_slice, 0, 0, desc.MipLevels, desc.DepthOrArraySize);
     UpdateSubresources<1>(_command_lists[0].Get(), buffer, upload_buffer.Get(), 0, subresource, 1, &copy_desc);
     _resource_barriers[buffer] = CD3DX12_RESOURCE_BARRIER::Transition(buffer, D3D12_RESOURCE_STATE_COPY_DEST,
                                                                       D3D12_RESOURCE_STATE_GENERIC_READ);
@@ -92,6 +100,33 @@ void ResourceUploader::RecordCopyData(ID3D12Resource *buffer, UINT mip_slice, co
 
 //----------------------------------------------------------------------------------------------------------------------
 
+void ResourceUploader::RecordCopyData(ID3D12Resource *buffer, const Image &image) {
+    auto count = static_cast<UINT>(image.subresources.size());
+
+    // Create an upload buffer which has all subresources.
+    ComPtr<ID3D12Resource> upload_buffer;
+    ThrowIfFailed(CreateUploadBuffer(_device, GetRequiredIntermediateSize(buffer, 0, count), &upload_buffer));
+
+    // Keep an upload buffer until a command list is completed.
+    _upload_buffers.push_back(upload_buffer);
+
+    // Define subresource data in the order of subresource indices.
+    std::vector<D3D12_SUBRESOURCE_DATA> copy_descs(count);
+    for (UINT i = 0; i != count; ++i) {
+        auto &subresource = image.subresources[i];
+        copy_descs[i].pData = subresource.data;
+        copy_descs[i].RowPitch = static_cast<LONG_PTR>(subresource.row_pitch);
+        copy_descs[i].SlicePitch = copy_descs[i].RowPitch * subresource.height;
+    }
+
+    // Record commands.
+    UpdateSubresources(_command_lists[0].Get(), buffer, upload_buffer.Get(), 0, 0, count, copy_descs.data());
+    _resource_barriers[buffer] = CD3DX12_RESOURCE_BARRIER::Transition(buffer, D3D12_RESOURCE_STATE_COPY_DEST,
+                                                                      D3D12_RESOURCE_STATE_GENERIC_READ);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 void ResourceUploader::Execute() {
     // Record resource barrier commands.
     std::vector<D3D12_RESOURCE_BARRIER> resource_barriers;
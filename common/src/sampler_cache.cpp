@@ -0,0 +1,89 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include "sampler_cache.h"
+
+#include <fmt/format.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "utility.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Hash the description of a sampler with FNV-1a. A description has no padding, so its bytes are hashed.
+//! \param desc The description of a sampler.
+//! \return A hash.
+inline UINT64 HashSamplerDesc(const D3D12_SAMPLER_DESC &desc) {
+    return HashBytes(kHashOffsetBasis, &desc, sizeof(desc));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+SamplerCache::SamplerCache(ID3D12Device *device, UINT capacity)
+        : _device(device), _slots(capacity, Slot{{}, 0, false}) {
+    D3D12_DESCRIPTOR_HEAP_DESC desc = {};
+    desc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER;
+    desc.NumDescriptors = capacity;
+    desc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+    ThrowIfFailed(_device->CreateDescriptorHeap(&desc, IID_PPV_ARGS(&_descriptor_heap)));
+
+    _descriptor_size = _device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+UINT SamplerCache::GetSampler(const D3D12_SAMPLER_DESC &desc, UINT64 fence_value, UINT64 completed_fence_value) {
+    // Return an existing sampler. It is kept until a frame using it is completed.
+    auto hash = HashSamplerDesc(desc);
+    auto [begin, end] = _indices.equal_range(hash);
+    for (auto iter = begin; iter != end; ++iter) {
+        auto &slot = _slots[iter->second];
+        if (!memcmp(&slot.desc, &desc, sizeof(desc))) {
+            slot.fence_value = std::max(slot.fence_value, fence_value);
+            return iter->second;
+        }
+    }
+
+    // Find a slot in ring order, so the least recently created sampler is replaced first.
+    // A slot which may be read by a frame in flight is skipped.
+    auto capacity = static_cast<UINT>(_slots.size());
+    for (UINT i = 0; i != capacity; ++i) {
+        auto index = (_next + i) % capacity;
+        auto &slot = _slots[index];
+        if (slot.occupied && slot.fence_value > completed_fence_value) {
+            continue;
+        }
+
+        if (slot.occupied) {
+            auto [old_begin, old_end] = _indices.equal_range(HashSamplerDesc(slot.desc));
+            _indices.erase(std::find_if(old_begin, old_end, [index](const auto &pair) {
+                return pair.second == index;
+            }));
+        }
+
+        auto cpu_handle = _descriptor_heap->GetCPUDescriptorHandleForHeapStart();
+        cpu_handle.ptr += static_cast<SIZE_T>(index) * _descriptor_size;
+        _device->CreateSampler(&desc, cpu_handle);
+
+        slot = {desc, fence_value, true};
+        _indices.emplace(hash, index);
+        _next = (index + 1) % capacity;
+        return index;
+    }
+
+    throw std::runtime_error(fmt::format("Fail to find a free slot in {} samplers.", capacity));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+D3D12_GPU_DESCRIPTOR_HANDLE SamplerCache::GetGPUHandle(UINT index) const {
+    auto gpu_handle = _descriptor_heap->GetGPUDescriptorHandleForHeapStart();
+    gpu_handle.ptr += static_cast<UINT64>(index) * _descriptor_size;
+    return gpu_handle;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,116 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include "shader_cache.h"
+
+#include <fmt/format.h>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <thread>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+ShaderCache::ShaderCache(const std::filesystem::path &directory)
+        : _directory(directory) {
+    // A cache is optional, so a failure only makes every load a miss.
+    std::error_code error_code;
+    std::filesystem::create_directories(_directory, error_code);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::optional<CachedShader> ShaderCache::Load(UINT64 key) const {
+    auto path = BuildPath(key);
+    std::ifstream fin(path, std::ios::in | std::ios::binary);
+    if (!fin.is_open()) {
+        return std::nullopt;
+    }
+
+    ShaderCacheHeader header = {};
+    if (!fin.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        header.magic != kShaderCacheMagic || header.version != kShaderCacheVersion || header.key != key) {
+        return std::nullopt;
+    }
+
+    // Sizes of a header must add up to the file size before anything is allocated, so a corrupted size is a miss.
+    std::error_code error_code;
+    auto file_size = std::filesystem::file_size(path, error_code);
+    if (error_code || file_size < sizeof(header) || header.size > file_size - sizeof(header) ||
+        sizeof(header) + header.size + header.dependencies_size != file_size) {
+        return std::nullopt;
+    }
+
+    CachedShader shader;
+    shader.code.resize(header.size);
+    std::string names(header.dependencies_size, '\0');
+    if (!fin.read(reinterpret_cast<char *>(shader.code.data()), static_cast<std::streamsize>(shader.code.size())) ||
+        !fin.read(names.data(), static_cast<std::streamsize>(names.size()))) {
+        return std::nullopt;
+    }
+
+    // Dependencies are UTF-8 paths separated by a terminator.
+    for (size_t begin = 0; shader.dependencies.size() != header.dependency_count;) {
+        auto end = names.find('\0', begin);
+        if (end == std::string::npos) {
+            return std::nullopt;
+        }
+
+        auto name = reinterpret_cast<const char8_t *>(names.data() + begin);
+        shader.dependencies.emplace_back(std::u8string(name, end - begin));
+        begin = end + 1;
+    }
+
+    return shader;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void ShaderCache::Store(UINT64 key, std::span<const BYTE> code,
+                        std::span<const std::filesystem::path> dependencies) const {
+    auto path = BuildPath(key);
+    auto temp_path = path;
+    temp_path += fmt::format(".{:x}.tmp", std::hash<std::thread::id>()(std::this_thread::get_id()));
+
+    {
+        std::ofstream fout(temp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!fout.is_open()) {
+            return;
+        }
+
+        std::string names;
+        for (auto &dependency : dependencies) {
+            auto name = dependency.generic_u8string();
+            names.append(name.begin(), name.end());
+            names.push_back('\0');
+        }
+
+        ShaderCacheHeader header = {kShaderCacheMagic, kShaderCacheVersion, key, code.size(),
+                                    static_cast<UINT32>(dependencies.size()), static_cast<UINT32>(names.size())};
+        fout.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        fout.write(reinterpret_cast<const char *>(code.data()), static_cast<std::streamsize>(code.size()));
+        fout.write(names.data(), static_cast<std::streamsize>(names.size()));
+        if (!fout) {
+            fout.close();
+            std::error_code error_code;
+            std::filesystem::remove(temp_path, error_code);
+            return;
+        }
+    }
+
+    std::error_code error_code;
+    std::filesystem::rename(temp_path, path, error_code);
+    if (error_code) {
+        std::filesystem::remove(temp_path, error_code);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::filesystem::path ShaderCache::BuildPath(UINT64 key) const {
+    return _directory / fmt::format("{:016x}.dxil", key);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
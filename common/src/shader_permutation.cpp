@@ -0,0 +1,116 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include "shader_permutation.h"
+
+#include <chrono>
+#include <span>
+#include <stdexcept>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+constexpr size_t kMaxKeywordCount = 32;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+ShaderPermutation::ShaderPermutation(Compiler *compiler, ShaderRequest request, std::vector<std::wstring> keywords,
+                                     UINT32 fallback_mask)
+        : _compiler(compiler), _request(std::move(request)), _keywords(std::move(keywords)),
+          _fallback_mask(fallback_mask) {
+    if (_keywords.size() > kMaxKeywordCount) {
+        throw std::runtime_error("A permutation can't have more than 32 keywords.");
+    }
+
+    CompileFallback();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+ShaderPermutation::~ShaderPermutation() {
+    for (auto &[mask, variant] : _variants) {
+        if (variant.future.valid()) {
+            variant.future.wait();
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+IDxcBlob *ShaderPermutation::GetVariant(UINT32 mask, UINT32 *served_mask) {
+    auto &variant = _variants[mask];
+
+    // Collect a completed compile. A failed variant keeps being served by the fallback variant.
+    if (variant.future.valid() && variant.future.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        try {
+            auto result = variant.future.get();
+            if (FAILED(result.result)) {
+                OutputDebugStringA(result.diagnostics.c_str());
+                variant.failed = true;
+            } else {
+                variant.code = result.code;
+            }
+        }
+        catch (const std::exception &exception) {
+            OutputDebugStringA(exception.what());
+            variant.failed = true;
+        }
+    }
+
+    if (variant.code) {
+        if (served_mask) {
+            *served_mask = mask;
+        }
+        return variant.code.Get();
+    }
+
+    if (!variant.failed && !variant.future.valid()) {
+        variant.future = std::async(std::launch::async, [this, request = BuildRequest(mask)]() {
+            return _compiler->CompileShaders(std::span(&request, 1))[0];
+        });
+    }
+
+    if (served_mask) {
+        *served_mask = _fallback_mask;
+    }
+    return _variants[_fallback_mask].code.Get();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void ShaderPermutation::Reset() {
+    for (auto &[mask, variant] : _variants) {
+        if (variant.future.valid()) {
+            variant.future.wait();
+        }
+    }
+    _variants.clear();
+
+    CompileFallback();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+ShaderRequest ShaderPermutation::BuildRequest(UINT32 mask) const {
+    auto request = _request;
+    for (size_t i = 0; i != _keywords.size(); ++i) {
+        request.defines.push_back({_keywords[i], mask & (1u << i) ? L"1" : L"0"});
+    }
+
+    return request;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void ShaderPermutation::CompileFallback() {
+    auto request = BuildRequest(_fallback_mask);
+    auto result = _compiler->CompileShaders(std::span(&request, 1))[0];
+    if (FAILED(result.result)) {
+        throw std::runtime_error(result.diagnostics);
+    }
+
+    _variants[_fallback_mask].code = result.code;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,380 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include "shader_reflection.h"
+
+#include <fmt/format.h>
+#include <algorithm>
+#include <bit>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+
+#include "utility.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// A constant buffer up to this size is put to root constants.
+constexpr UINT kMaxRootConstantSize = 64;
+
+// The size of root arguments in DWORDs. A descriptor table costs 1 DWORD, a root descriptor costs 2 DWORDs
+// and root constants cost 1 DWORD per value.
+constexpr UINT kMaxRootSignatureSize = 64;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Retrieve the format of a vertex element.
+//! \param type The component type of an element.
+//! \param count The number of components.
+//! \return A format, or DXGI_FORMAT_UNKNOWN if a type isn't supported.
+inline DXGI_FORMAT GetElementFormat(D3D_REGISTER_COMPONENT_TYPE type, UINT count) {
+    static const DXGI_FORMAT kFloatFormats[] = {DXGI_FORMAT_R32_FLOAT, DXGI_FORMAT_R32G32_FLOAT,
+                                                DXGI_FORMAT_R32G32B32_FLOAT, DXGI_FORMAT_R32G32B32A32_FLOAT};
+    static const DXGI_FORMAT kUIntFormats[] = {DXGI_FORMAT_R32_UINT, DXGI_FORMAT_R32G32_UINT,
+                                               DXGI_FORMAT_R32G32B32_UINT, DXGI_FORMAT_R32G32B32A32_UINT};
+    static const DXGI_FORMAT kSIntFormats[] = {DXGI_FORMAT_R32_SINT, DXGI_FORMAT_R32G32_SINT,
+                                               DXGI_FORMAT_R32G32B32_SINT, DXGI_FORMAT_R32G32B32A32_SINT};
+
+    if (count < 1 || count > 4) {
+        return DXGI_FORMAT_UNKNOWN;
+    }
+
+    switch (type) {
+        case D3D_REGISTER_COMPONENT_FLOAT32:
+            return kFloatFormats[count - 1];
+        case D3D_REGISTER_COMPONENT_UINT32:
+            return kUIntFormats[count - 1];
+        case D3D_REGISTER_COMPONENT_SINT32:
+            return kSIntFormats[count - 1];
+        default:
+            return DXGI_FORMAT_UNKNOWN;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Retrieve the descriptor range type of a resource.
+//! \param type The type of a resource.
+//! \return A descriptor range type.
+inline D3D12_DESCRIPTOR_RANGE_TYPE GetRangeType(D3D_SHADER_INPUT_TYPE type) {
+    switch (type) {
+        case D3D_SIT_CBUFFER:
+            return D3D12_DESCRIPTOR_RANGE_TYPE_CBV;
+        case D3D_SIT_SAMPLER:
+            return D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER;
+        case D3D_SIT_UAV_RWTYPED:
+        case D3D_SIT_UAV_RWSTRUCTURED:
+        case D3D_SIT_UAV_RWBYTEADDRESS:
+        case D3D_SIT_UAV_APPEND_STRUCTURED:
+        case D3D_SIT_UAV_CONSUME_STRUCTURED:
+        case D3D_SIT_UAV_RWSTRUCTURED_WITH_COUNTER:
+            return D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+        default:
+            return D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Retrieve the visibility of stages.
+//! \param stages A bitmask of shader types which use a parameter.
+//! \return The visibility of a parameter.
+inline D3D12_SHADER_VISIBILITY GetVisibility(UINT stages) {
+    if (std::popcount(stages) != 1) {
+        return D3D12_SHADER_VISIBILITY_ALL;
+    }
+
+    switch (std::countr_zero(stages)) {
+        case D3D12_SHVER_PIXEL_SHADER:
+            return D3D12_SHADER_VISIBILITY_PIXEL;
+        case D3D12_SHVER_VERTEX_SHADER:
+            return D3D12_SHADER_VISIBILITY_VERTEX;
+        case D3D12_SHVER_GEOMETRY_SHADER:
+            return D3D12_SHADER_VISIBILITY_GEOMETRY;
+        case D3D12_SHVER_HULL_SHADER:
+            return D3D12_SHADER_VISIBILITY_HULL;
+        case D3D12_SHVER_DOMAIN_SHADER:
+            return D3D12_SHADER_VISIBILITY_DOMAIN;
+        default:
+            return D3D12_SHADER_VISIBILITY_ALL;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+InputLayout::InputLayout(ID3D12ShaderReflection *reflection) {
+    D3D12_SHADER_DESC shader_desc;
+    ThrowIfFailed(reflection->GetDesc(&shader_desc));
+
+    std::vector<D3D12_SIGNATURE_PARAMETER_DESC> parameters;
+    for (UINT i = 0; i != shader_desc.InputParameters; ++i) {
+        D3D12_SIGNATURE_PARAMETER_DESC parameter;
+        ThrowIfFailed(reflection->GetInputParameterDesc(i, &parameter));
+
+        if (parameter.SystemValueType == D3D_NAME_UNDEFINED) {
+            parameters.push_back(parameter);
+        }
+    }
+
+    // Copy semantic names first, so elements can point to them.
+    for (auto &parameter : parameters) {
+        _semantic_names.emplace_back(parameter.SemanticName);
+    }
+
+    _hash = kHashOffsetBasis;
+    UINT offset = 0;
+    for (UINT i = 0; i != parameters.size(); ++i) {
+        auto &parameter = parameters[i];
+        auto count = static_cast<UINT>(std::bit_width(static_cast<UINT>(parameter.Mask)));
+        auto format = GetElementFormat(parameter.ComponentType, count);
+        if (format == DXGI_FORMAT_UNKNOWN) {
+            throw std::runtime_error(fmt::format("Fail to build an input layout: unsupported type of {}{}.",
+                                                 parameter.SemanticName, parameter.SemanticIndex));
+        }
+
+        _elements.push_back({_semantic_names[i].c_str(), parameter.SemanticIndex, format, 0, offset,
+                             D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0});
+        offset += count * sizeof(UINT32);
+
+        _hash = HashBytes(_hash, _semantic_names[i].c_str(), _semantic_names[i].size() + 1);
+        auto &element = _elements.back();
+        UINT32 values[] = {element.SemanticIndex, static_cast<UINT32>(element.Format), element.AlignedByteOffset};
+        _hash = HashBytes(_hash, values, sizeof(values));
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+RootSignatureLayout::RootSignatureLayout(std::span<ID3D12ShaderReflection *const> reflections,
+                                         std::span<const D3D12_STATIC_SAMPLER_DESC> static_samplers)
+        : _static_samplers(static_samplers.begin(), static_samplers.end()) {
+    struct Binding {
+        std::string name;
+        UINT bind_count = 0;
+        UINT size = 0;
+        UINT stages = 0;
+        bool is_root = false;
+    };
+
+    // Merge bindings of shaders. Bindings are sorted by a type, a space and a register.
+    std::map<std::tuple<D3D12_DESCRIPTOR_RANGE_TYPE, UINT, UINT>, Binding> bindings;
+    UINT stages = 0;
+    auto has_input = false;
+    for (auto reflection : reflections) {
+        D3D12_SHADER_DESC shader_desc;
+        ThrowIfFailed(reflection->GetDesc(&shader_desc));
+
+        auto type = D3D12_SHVER_GET_TYPE(shader_desc.Version);
+        auto stage = 1u << type;
+        stages |= stage;
+
+        for (UINT i = 0; i != shader_desc.InputParameters && type == D3D12_SHVER_VERTEX_SHADER; ++i) {
+            D3D12_SIGNATURE_PARAMETER_DESC parameter;
+            ThrowIfFailed(reflection->GetInputParameterDesc(i, &parameter));
+            has_input |= parameter.SystemValueType == D3D_NAME_UNDEFINED;
+        }
+
+        for (UINT i = 0; i != shader_desc.BoundResources; ++i) {
+            D3D12_SHADER_INPUT_BIND_DESC bind_desc;
+            ThrowIfFailed(reflection->GetResourceBindingDesc(i, &bind_desc));
+
+            auto range_type = GetRangeType(bind_desc.Type);
+            if (range_type == D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER &&
+                std::any_of(_static_samplers.begin(), _static_samplers.end(), [&bind_desc](const auto &sampler) {
+                    return sampler.ShaderRegister == bind_desc.BindPoint && sampler.RegisterSpace == bind_desc.Space;
+                })) {
+                continue;
+            }
+
+            // An unbounded array is reported with no count.
+            auto &binding = bindings[{range_type, bind_desc.Space, bind_desc.BindPoint}];
+            binding.name = bind_desc.Name;
+            binding.bind_count = bind_desc.BindCount ? std::max(binding.bind_count, bind_desc.BindCount) : UINT_MAX;
+            binding.stages |= stage;
+
+            if (range_type == D3D12_DESCRIPTOR_RANGE_TYPE_CBV) {
+                D3D12_SHADER_BUFFER_DESC buffer_desc;
+                ThrowIfFailed(reflection->GetConstantBufferByName(bind_desc.Name)->GetDesc(&buffer_desc));
+                binding.size = std::max(binding.size, buffer_desc.Size);
+            }
+        }
+    }
+
+    // Descriptor tables are counted first, so constant buffers spend the rest of root arguments.
+    auto has_table = false;
+    auto has_sampler_table = false;
+    UINT root_size = 0;
+    for (auto &[key, binding] : bindings) {
+        auto range_type = std::get<0>(key);
+        if (binding.bind_count == UINT_MAX) {
+            ++root_size;
+        } else if (range_type == D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER) {
+            has_sampler_table = true;
+        } else if (range_type != D3D12_DESCRIPTOR_RANGE_TYPE_CBV || binding.bind_count != 1) {
+            has_table = true;
+        }
+    }
+    root_size += (has_table ? 1 : 0) + (has_sampler_table ? 1 : 0);
+
+    // Put a constant buffer to root constants or a root descriptor, so it doesn't need a descriptor. A constant
+    // buffer which doesn't fit falls back to a root descriptor and then to a descriptor table, and a DWORD is kept
+    // for the table until it exists.
+    for (auto &[key, binding] : bindings) {
+        auto [range_type, space, bind_point] = key;
+        if (range_type != D3D12_DESCRIPTOR_RANGE_TYPE_CBV || binding.bind_count != 1) {
+            continue;
+        }
+
+        auto table_size = has_table ? 0u : 1u;
+        auto constant_count = binding.size / static_cast<UINT>(sizeof(UINT32));
+
+        D3D12_ROOT_PARAMETER parameter = {};
+        parameter.ShaderVisibility = GetVisibility(binding.stages);
+        if (binding.size <= kMaxRootConstantSize && root_size + table_size + constant_count <= kMaxRootSignatureSize) {
+            parameter.ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+            parameter.Constants = {bind_point, space, constant_count};
+            root_size += constant_count;
+        } else if (root_size + table_size + 2 <= kMaxRootSignatureSize) {
+            parameter.ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+            parameter.Descriptor = {bind_point, space};
+            root_size += 2;
+        } else {
+            root_size += table_size;
+            has_table = true;
+            continue;
+        }
+
+        binding.is_root = true;
+        _bindings[binding.name] = {static_cast<UINT>(_parameters.size()), 0};
+        _parameters.push_back(parameter);
+    }
+
+    // Merge other descriptors into a table of each heap. An unbounded range must be the last of a table,
+    // so it has a table of its own after the merged table.
+    std::vector<UINT> table_stages;
+    for (auto sampler : {false, true}) {
+        std::vector<D3D12_DESCRIPTOR_RANGE> ranges;
+        std::vector<std::pair<D3D12_DESCRIPTOR_RANGE, const Binding *>> unbounded_ranges;
+        auto table_index = static_cast<UINT>(_parameters.size() + _ranges.size());
+        UINT stages_of_table = 0;
+        UINT offset = 0;
+
+        for (auto &[key, binding] : bindings) {
+            auto [range_type, space, bind_point] = key;
+            if ((range_type == D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER) != sampler || binding.is_root) {
+                continue;
+            }
+
+            if (binding.bind_count == UINT_MAX) {
+                unbounded_ranges.push_back({{range_type, UINT_MAX, bind_point, space, 0}, &binding});
+                continue;
+            }
+
+            _bindings[binding.name] = {table_index, offset};
+            ranges.push_back({range_type, binding.bind_count, bind_point, space, offset});
+            stages_of_table |= binding.stages;
+            offset += binding.bind_count;
+        }
+
+        if (!ranges.empty()) {
+            _ranges.push_back(std::move(ranges));
+            table_stages.push_back(stages_of_table);
+        }
+
+        for (auto &[range, binding] : unbounded_ranges) {
+            _bindings[binding->name] = {static_cast<UINT>(_parameters.size() + _ranges.size()), 0};
+            _ranges.push_back({range});
+            table_stages.push_back(binding->stages);
+        }
+    }
+
+    // Ranges are never changed from here, so tables can point to them.
+    for (UINT i = 0; i != _ranges.size(); ++i) {
+        D3D12_ROOT_PARAMETER parameter = {};
+        parameter.ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+        parameter.DescriptorTable = {static_cast<UINT>(_ranges[i].size()), _ranges[i].data()};
+        parameter.ShaderVisibility = GetVisibility(table_stages[i]);
+        _parameters.push_back(parameter);
+    }
+
+    // Deny root access of stages which have no shader, so the driver can skip them.
+    auto flags = D3D12_ROOT_SIGNATURE_FLAG_NONE;
+    if (has_input) {
+        flags |= D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+    }
+
+    if (!(stages & (1u << D3D12_SHVER_COMPUTE_SHADER))) {
+        std::pair<D3D12_SHADER_VERSION_TYPE, D3D12_ROOT_SIGNATURE_FLAGS> kDenyFlags[] = {
+                {D3D12_SHVER_VERTEX_SHADER,   D3D12_ROOT_SIGNATURE_FLAG_DENY_VERTEX_SHADER_ROOT_ACCESS},
+                {D3D12_SHVER_HULL_SHADER,     D3D12_ROOT_SIGNATURE_FLAG_DENY_HULL_SHADER_ROOT_ACCESS},
+                {D3D12_SHVER_DOMAIN_SHADER,   D3D12_ROOT_SIGNATURE_FLAG_DENY_DOMAIN_SHADER_ROOT_ACCESS},
+                {D3D12_SHVER_GEOMETRY_SHADER, D3D12_ROOT_SIGNATURE_FLAG_DENY_GEOMETRY_SHADER_ROOT_ACCESS},
+                {D3D12_SHVER_PIXEL_SHADER,    D3D12_ROOT_SIGNATURE_FLAG_DENY_PIXEL_SHADER_ROOT_ACCESS}};
+
+        for (auto [type, deny_flag] : kDenyFlags) {
+            if (!(stages & (1u << type))) {
+                flags |= deny_flag;
+            }
+        }
+    }
+
+    _desc = {static_cast<UINT>(_parameters.size()), _parameters.data(),
+             static_cast<UINT>(_static_samplers.size()), _static_samplers.data(), flags};
+
+    // Encode a root signature without pointers, so equal root signatures have the same encoding.
+    _encoding.push_back(static_cast<UINT32>(flags));
+    for (auto &parameter : _parameters) {
+        _encoding.push_back(static_cast<UINT32>(parameter.ParameterType));
+        _encoding.push_back(static_cast<UINT32>(parameter.ShaderVisibility));
+
+        switch (parameter.ParameterType) {
+            case D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE:
+                _encoding.push_back(parameter.DescriptorTable.NumDescriptorRanges);
+                for (UINT i = 0; i != parameter.DescriptorTable.NumDescriptorRanges; ++i) {
+                    auto &range = parameter.DescriptorTable.pDescriptorRanges[i];
+                    _encoding.insert(_encoding.end(), {static_cast<UINT32>(range.RangeType), range.NumDescriptors,
+                                                       range.BaseShaderRegister, range.RegisterSpace,
+                                                       range.OffsetInDescriptorsFromTableStart});
+                }
+                break;
+            case D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS:
+                _encoding.insert(_encoding.end(), {parameter.Constants.ShaderRegister,
+                                                   parameter.Constants.RegisterSpace,
+                                                   parameter.Constants.Num32BitValues});
+                break;
+            default:
+                _encoding.insert(_encoding.end(), {parameter.Descriptor.ShaderRegister,
+                                                   parameter.Descriptor.RegisterSpace});
+                break;
+        }
+    }
+
+    for (auto &sampler : _static_samplers) {
+        _encoding.insert(_encoding.end(), {static_cast<UINT32>(sampler.Filter), static_cast<UINT32>(sampler.AddressU),
+                                           static_cast<UINT32>(sampler.AddressV),
+                                           static_cast<UINT32>(sampler.AddressW),
+                                           std::bit_cast<UINT32>(sampler.MipLODBias), sampler.MaxAnisotropy,
+                                           static_cast<UINT32>(sampler.ComparisonFunc),
+                                           static_cast<UINT32>(sampler.BorderColor),
+                                           std::bit_cast<UINT32>(sampler.MinLOD), std::bit_cast<UINT32>(sampler.MaxLOD),
+                                           sampler.ShaderRegister, sampler.RegisterSpace,
+                                           static_cast<UINT32>(sampler.ShaderVisibility)});
+    }
+
+    _hash = HashBytes(kHashOffsetBasis, _encoding.data(), _encoding.size() * sizeof(UINT32));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::optional<RootBinding> RootSignatureLayout::FindBinding(std::string_view name) const {
+    auto iter = _bindings.find(std::string(name));
+    if (iter == _bindings.end()) {
+        return std::nullopt;
+    }
+
+    return iter->second;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
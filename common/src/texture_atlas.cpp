@@ -0,0 +1,276 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+
+#include "texture_atlas.h"
+
+#include <fmt/format.h>
+#include <imstb_rectpack.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+#include "thread_pool.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+constexpr UINT kTexelSize = 4;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Check a format is a sRGB format or not.
+//! \param format A format.
+//! \return True if a format is a sRGB format.
+inline bool IsSRGB(DXGI_FORMAT format) {
+    return format == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB || format == DXGI_FORMAT_B8G8R8A8_UNORM_SRGB;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Retrieve a texel of a page.
+//! \param page A page.
+//! \param mip_slice The mip slice.
+//! \param x The x coordinate of a texel.
+//! \param y The y coordinate of a texel.
+//! \return A texel.
+inline BYTE *GetTexel(Image *page, UINT16 mip_slice, UINT x, UINT y) {
+    auto &subresource = page->subresources[mip_slice];
+    auto offset = subresource.data - page->contents.data();
+    return page->contents.data() + offset + y * subresource.row_pitch + x * kTexelSize;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Convert from a sRGB component to a linear component.
+//! \param value A sRGB component.
+//! \return A linear component.
+inline float ConvertSRGBToLinear(BYTE value) {
+    static const auto kTable = []() {
+        std::array<float, 256> table = {};
+        for (auto i = 0; i != 256; ++i) {
+            auto c = i / 255.0f;
+            table[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+        return table;
+    }();
+
+    return kTable[value];
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Convert from a linear component to a sRGB component.
+//! \param value A linear component.
+//! \return A sRGB component.
+inline BYTE ConvertLinearToSRGB(float value) {
+    auto c = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+    return static_cast<BYTE>(std::clamp(c, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TextureAtlas::TextureAtlas(std::span<const Image *const> images, UINT page_size, UINT16 mip_levels)
+        : _page_size(page_size), _mip_levels(mip_levels) {
+    // Cells are aligned to the texel of the smallest mip, so a texel of any mip never straddles two cells.
+    // A gutter is a texel of the smallest mip, so bilinear filtering of any mip doesn't bleed to a neighbour.
+    if (_mip_levels == 0 || _mip_levels > std::bit_width(_page_size)) {
+        throw std::runtime_error(fmt::format("Fail to build an atlas: {} mips don't fit to a page of {}.",
+                                             _mip_levels, _page_size));
+    }
+
+    auto alignment = 1u << (_mip_levels - 1);
+    _padding = alignment;
+    if (_page_size % alignment) {
+        throw std::runtime_error(fmt::format("Fail to build an atlas: page size must be a multiple of {}.",
+                                             alignment));
+    }
+
+    // An atlas of no images has no pages.
+    if (images.empty()) {
+        return;
+    }
+
+    auto format = images[0]->format;
+    for (auto image : images) {
+        if (image->format != format) {
+            throw std::runtime_error("All images of an atlas must have the same format.");
+        }
+    }
+
+    if (format != DXGI_FORMAT_R8G8B8A8_UNORM && format != DXGI_FORMAT_R8G8B8A8_UNORM_SRGB &&
+        format != DXGI_FORMAT_B8G8R8A8_UNORM && format != DXGI_FORMAT_B8G8R8A8_UNORM_SRGB) {
+        throw std::runtime_error(
+                fmt::format("Fail to build an atlas: unsupported format {}.", static_cast<int>(format)));
+    }
+
+    // Pack in units of alignment, so the positions of cells are aligned too.
+    auto page_units = _page_size / alignment;
+    std::vector<stbrp_rect> rects(images.size());
+    for (UINT i = 0; i != images.size(); ++i) {
+        auto width = (images[i]->width + _padding * 2 + alignment - 1) / alignment;
+        auto height = (images[i]->height + _padding * 2 + alignment - 1) / alignment;
+        if (images[i]->width == 0 || images[i]->height == 0 || width > page_units || height > page_units) {
+            throw std::runtime_error(fmt::format("Fail to pack an image: {}x{} doesn't fit to a page.",
+                                                 images[i]->width, images[i]->height));
+        }
+
+        rects[i].id = i;
+        rects[i].w = static_cast<stbrp_coord>(width);
+        rects[i].h = static_cast<stbrp_coord>(height);
+    }
+
+    // Pack rects into a page, and unpacked rects overflow to the next page.
+    std::vector<std::vector<Cell>> cells;
+    std::vector<stbrp_node> nodes(page_units);
+    _regions.resize(images.size());
+    while (!rects.empty()) {
+        stbrp_context context;
+        auto units = static_cast<int>(page_units);
+        stbrp_init_target(&context, units, units, nodes.data(), units);
+        stbrp_pack_rects(&context, rects.data(), static_cast<int>(rects.size()));
+
+        auto &page_cells = cells.emplace_back();
+        for (auto &rect : rects) {
+            if (!rect.was_packed) {
+                continue;
+            }
+
+            auto image = images[rect.id];
+            Cell cell = {image, rect.x * alignment, rect.y * alignment, rect.w * alignment, rect.h * alignment};
+            page_cells.push_back(cell);
+
+            auto &region = _regions[rect.id];
+            region.page = static_cast<UINT>(cells.size() - 1);
+            region.scale_u = static_cast<float>(image->width) / _page_size;
+            region.scale_v = static_cast<float>(image->height) / _page_size;
+            region.offset_u = static_cast<float>(cell.x + _padding) / _page_size;
+            region.offset_v = static_cast<float>(cell.y + _padding) / _page_size;
+        }
+
+        std::erase_if(rects, [](const auto &rect) { return rect.was_packed; });
+    }
+
+    // Allocate pages with all mips. Texels which aren't covered by any cell are cleared.
+    _pages.resize(cells.size());
+    for (auto &page : _pages) {
+        page.width = _page_size;
+        page.height = _page_size;
+        page.array_size = 1;
+        page.mip_levels = _mip_levels;
+        page.format = format;
+
+        UINT64 size = 0;
+        for (auto mip = 0; mip != _mip_levels; ++mip) {
+            auto dimension = _page_size >> mip;
+            size += static_cast<UINT64>(dimension) * dimension * kTexelSize;
+        }
+        page.contents.resize(size);
+
+        auto data = page.contents.data();
+        for (auto mip = 0; mip != _mip_levels; ++mip) {
+            auto dimension = _page_size >> mip;
+
+            Subresource subresource;
+            subresource.data = data;
+            subresource.row_pitch = dimension * kTexelSize;
+            subresource.height = dimension;
+            page.subresources.push_back(subresource);
+
+            data += subresource.row_pitch * subresource.height;
+        }
+    }
+
+    // Fill cells on worker threads. Cells don't overlap, so workers never write the same texel.
+    std::vector<std::pair<const Cell *, Image *>> jobs;
+    for (UINT i = 0; i != cells.size(); ++i) {
+        for (auto &cell : cells[i]) {
+            jobs.emplace_back(&cell, &_pages[i]);
+        }
+    }
+
+    ThreadPool thread_pool(static_cast<UINT>(std::min<size_t>(std::thread::hardware_concurrency(), jobs.size())));
+    std::vector<std::future<void>> futures;
+    for (auto [cell, page] : jobs) {
+        futures.push_back(thread_pool.Submit([this, cell, page]() {
+            FillCell(*cell, page);
+            GenerateMips(*cell, page);
+        }));
+    }
+
+    for (auto &future : futures) {
+        future.get();
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void TextureAtlas::FillCell(const Cell &cell, Image *page) const {
+    auto image = cell.image;
+    auto &source = image->subresources[0];
+    auto row_size = image->width * kTexelSize;
+
+    for (UINT row = 0; row != cell.height; ++row) {
+        auto src_y = std::clamp<INT>(row - _padding, 0, image->height - 1);
+        auto src = source.data + src_y * source.row_pitch;
+        auto dst = GetTexel(page, 0, cell.x, cell.y + row);
+
+        // Copy a row of an image, and then extend the first texel and the last texel to the gutter.
+        memcpy(dst + _padding * kTexelSize, src, row_size);
+        for (UINT i = 0; i != _padding; ++i) {
+            memcpy(dst + i * kTexelSize, src, kTexelSize);
+        }
+        for (auto i = _padding + image->width; i != cell.width; ++i) {
+            memcpy(dst + i * kTexelSize, src + row_size - kTexelSize, kTexelSize);
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void TextureAtlas::GenerateMips(const Cell &cell, Image *page) const {
+    auto srgb = IsSRGB(page->format);
+
+    for (UINT16 mip = 1; mip != _mip_levels; ++mip) {
+        auto x = cell.x >> mip;
+        auto y = cell.y >> mip;
+        auto width = cell.width >> mip;
+        auto height = cell.height >> mip;
+
+        for (UINT row = 0; row != height; ++row) {
+            auto src0 = GetTexel(page, mip - 1, x * 2, (y + row) * 2);
+            auto src1 = GetTexel(page, mip - 1, x * 2, (y + row) * 2 + 1);
+            auto dst = GetTexel(page, mip, x, y + row);
+
+            for (UINT column = 0; column != width; ++column) {
+                auto t00 = src0 + column * 2 * kTexelSize;
+                auto t01 = t00 + kTexelSize;
+                auto t10 = src1 + column * 2 * kTexelSize;
+                auto t11 = t10 + kTexelSize;
+
+                // Color of a sRGB format is averaged in linear space. Alpha is always linear.
+                for (UINT i = 0; i != kTexelSize; ++i) {
+                    if (srgb && i != 3) {
+                        auto sum = ConvertSRGBToLinear(t00[i]) + ConvertSRGBToLinear(t01[i]) +
+                                   ConvertSRGBToLinear(t10[i]) + ConvertSRGBToLinear(t11[i]);
+                        dst[i] = ConvertLinearToSRGB(sum * 0.25f);
+                    } else {
+                        dst[i] = static_cast<BYTE>((t00[i] + t01[i] + t10[i] + t11[i] + 2) / 4);
+                    }
+                }
+
+                dst += kTexelSize;
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
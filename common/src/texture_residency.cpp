@@ -0,0 +1,181 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include "texture_residency.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <queue>
+#include <tuple>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+constexpr UINT64 kTailSize = 64 * 1024;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TextureResidency::TextureResidency(const ResidencyBudget &budget)
+        : _budget(budget) {
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+UINT TextureResidency::AddTexture(const Image &image) {
+    assert(image.mip_levels > 0);
+
+    Texture texture;
+
+    // Calculate the byte size of each mip across all array slices.
+    texture.mip_sizes.resize(image.mip_levels);
+    for (auto layer = 0; layer != image.array_size; ++layer) {
+        for (auto mip = 0; mip != image.mip_levels; ++mip) {
+            auto &subresource = image.subresources[mip + layer * image.mip_levels];
+            texture.mip_sizes[mip] += subresource.row_pitch * subresource.height;
+        }
+    }
+
+    // The smallest mips which fit to the tail size are always resident.
+    texture.tail_mip = image.mip_levels - 1;
+    auto tail_size = texture.mip_sizes[texture.tail_mip];
+    while (texture.tail_mip > 0 && tail_size + texture.mip_sizes[texture.tail_mip - 1] <= kTailSize) {
+        tail_size += texture.mip_sizes[--texture.tail_mip];
+    }
+
+    texture.resident_mip = texture.tail_mip;
+    _resident_size += tail_size;
+
+    _textures.push_back(texture);
+    return static_cast<UINT>(_textures.size() - 1);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void TextureResidency::SetDistance(UINT texture, float distance) {
+    _textures[texture].distance = distance;
+    _textures[texture].last_used_frame = _frame;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::vector<StreamRequest> TextureResidency::Update() {
+    // Textures which are used in this frame and need finer mips. The texture which lacks the most mips is loaded first,
+    // and the closer texture wins on a tie.
+    auto compare = [this](UINT lhs, UINT rhs) {
+        auto lack = [this](UINT index) {
+            return _textures[index].resident_mip - GetRequiredMip(index);
+        };
+        return std::make_tuple(lack(lhs), -_textures[lhs].distance) <
+               std::make_tuple(lack(rhs), -_textures[rhs].distance);
+    };
+    std::priority_queue<UINT, std::vector<UINT>, decltype(compare)> queue(compare);
+
+    for (UINT i = 0; i != _textures.size(); ++i) {
+        if (_textures[i].last_used_frame == _frame && GetRequiredMip(i) < _textures[i].resident_mip) {
+            queue.push(i);
+        }
+    }
+
+    // Stream mips within the upload budget.
+    std::vector<StreamRequest> requests;
+    UINT64 upload_size = 0;
+    while (!queue.empty()) {
+        auto index = queue.top();
+        queue.pop();
+
+        auto &texture = _textures[index];
+        auto mip = static_cast<UINT16>(texture.resident_mip - 1);
+        auto size = texture.mip_sizes[mip];
+
+        // A mip which is larger than the upload budget is streamed alone.
+        if (upload_size && upload_size + size > _budget.upload_size) {
+            break;
+        }
+
+        if (!EvictFor(size, index)) {
+            break;
+        }
+
+        texture.resident_mip = mip;
+        _resident_size += size;
+        upload_size += size;
+        requests.push_back({index, mip});
+
+        if (GetRequiredMip(index) < texture.resident_mip) {
+            queue.push(index);
+        }
+    }
+
+    ++_frame;
+
+    return requests;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+UINT16 TextureResidency::GetResidentMip(UINT texture) const {
+    return _textures[texture].resident_mip;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+UINT16 TextureResidency::GetRequiredMip(UINT texture) const {
+    auto &residency = _textures[texture];
+
+    // Each time the distance doubles, the next coarser mip is enough.
+    auto lod = std::floor(std::log2(residency.distance / _budget.full_detail_distance));
+
+    // A close, negative or NaN distance requires full detail. Converting NaN or a negative value is undefined.
+    if (!(lod > 0.0f)) {
+        return 0;
+    }
+
+    return static_cast<UINT16>(std::min(lod, static_cast<float>(residency.tail_mip)));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+bool TextureResidency::EvictFor(UINT64 size, UINT keep) {
+    while (_resident_size + size > _budget.memory_size) {
+        // Find the victim. Mips finer than required are evicted first, then the least recently used textures.
+        // Textures which are used in this frame and need all of their mips are never evicted.
+        auto victim = static_cast<UINT>(_textures.size());
+        for (UINT i = 0; i != _textures.size(); ++i) {
+            auto &texture = _textures[i];
+            if (i == keep || texture.resident_mip == texture.tail_mip) {
+                continue;
+            }
+
+            auto surplus = texture.resident_mip < GetRequiredMip(i);
+            if (!surplus && texture.last_used_frame == _frame) {
+                continue;
+            }
+
+            if (victim == _textures.size()) {
+                victim = i;
+            } else {
+                auto &candidate = _textures[victim];
+                auto candidate_surplus = candidate.resident_mip < GetRequiredMip(victim);
+                if (std::make_tuple(!surplus, texture.last_used_frame) <
+                    std::make_tuple(!candidate_surplus, candidate.last_used_frame)) {
+                    victim = i;
+                }
+            }
+        }
+
+        if (victim == _textures.size()) {
+            return false;
+        }
+
+        // Evict the most detailed resident mip of the victim.
+        auto &texture = _textures[victim];
+        _resident_size -= texture.mip_sizes[texture.resident_mip];
+        ++texture.resident_mip;
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
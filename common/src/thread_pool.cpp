@@ -0,0 +1,58 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include "thread_pool.h"
+
+#include <algorithm>
+
+#include "profiler.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+ThreadPool::ThreadPool(UINT thread_count) {
+    thread_count = std::max(thread_count, 1u);
+    for (UINT i = 0; i != thread_count; ++i) {
+        _threads.emplace_back(&ThreadPool::Run, this);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(_mutex);
+        _stop = true;
+    }
+    _condition.notify_all();
+
+    for (auto &thread : _threads) {
+        thread.join();
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void ThreadPool::Run() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock lock(_mutex);
+            _condition.wait(lock, [this]() { return _stop || !_tasks.empty(); });
+
+            // Remaining tasks are drained before a worker thread exits.
+            if (_tasks.empty()) {
+                return;
+            }
+
+            task = std::move(_tasks.front());
+            _tasks.pop();
+        }
+
+        ProfileScope("Task");
+        task();
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
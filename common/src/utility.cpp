@@ -34,17 +34,28 @@ inline HRESULT CreateBuffer(ID3D12Device *device, D3D12_HEAP_TYPE heap_type, UIN
 //----------------------------------------------------------------------------------------------------------------------
 
 inline HRESULT CreateTexture2D(ID3D12Device *device, D3D12_HEAP_TYPE heap_type, UINT64 width, UINT height,
-                               UINT16 mip_levels, DXGI_FORMAT format, D3D12_RESOURCE_FLAGS flags,
+                               UINT16 array_size, UINT16 mip_levels, DXGI_FORMAT format, D3D12_RESOURCE_FLAGS flags,
                                D3D12_RESOURCE_STATES resource_state, const D3D12_CLEAR_VALUE *clear_value,
                                ID3D12Resource **buffer) {
     auto heap_properties = CD3DX12_HEAP_PROPERTIES(heap_type);
-    auto desc = CD3DX12_RESOURCE_DESC::Tex2D(format, width, height, 1, mip_levels, 1, 0, flags);
+    auto desc = CD3DX12_RESOURCE_DESC::Tex2D(format, width, height, array_size, mip_levels, 1, 0, flags);
     return device->CreateCommittedResource(&heap_properties, D3D12_HEAP_FLAG_NONE, &desc, resource_state,
                                            clear_value, IID_PPV_ARGS(buffer));
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
+UINT64 HashBytes(UINT64 hash, const void *data, size_t size) {
+    auto bytes = static_cast<const BYTE *>(data);
+    for (size_t i = 0; i != size; ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+
+    return hash;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 std::string ConvertUTF16ToUTF8(const wchar_t *utf16) {
     auto size = WideCharToMultiByte(CP_ACP, 0, utf16, -1, nullptr, 0, nullptr, nullptr);
     std::string utf8(size, ' ');
@@ -158,7 +169,7 @@ HRESULT CreateConstantBuffer(ID3D12Device *device, UINT64 size, ID3D12Resource *
 
 HRESULT CreateDefaultTexture2D(ID3D12Device *device, UINT64 width, UINT height, UINT16 mip_levels,
                                DXGI_FORMAT format, ID3D12Resource **buffer) {
-    return CreateTexture2D(device, D3D12_HEAP_TYPE_DEFAULT, width, height, mip_levels, format,
+    return CreateTexture2D(device, D3D12_HEAP_TYPE_DEFAULT, width, height, 1, mip_levels, format,
                            D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_COPY_DEST, nullptr, buffer);
 }
 
@@ -166,7 +177,7 @@ HRESULT CreateDefaultTexture2D(ID3D12Device *device, UINT64 width, UINT height,
 
 HRESULT CreateDefaultTexture2D(ID3D12Device *device, UINT64 width, UINT height, UINT16 mip_levels,
                                DXGI_FORMAT format, D3D12_RESOURCE_FLAGS flags, ID3D12Resource **buffer) {
-    return CreateTexture2D(device, D3D12_HEAP_TYPE_DEFAULT, width, height, mip_levels, format,
+    return CreateTexture2D(device, D3D12_HEAP_TYPE_DEFAULT, width, height, 1, mip_levels, format,
                            flags, D3D12_RESOURCE_STATE_COPY_DEST, nullptr, buffer);
 }
 
@@ -175,7 +186,7 @@ HRESULT CreateDefaultTexture2D(ID3D12Device *device, UINT64 width, UINT height,
 HRESULT CreateDefaultTexture2D(ID3D12Device *device, UINT64 width, UINT height, UINT16 mip_levels,
                                DXGI_FORMAT format, D3D12_RESOURCE_FLAGS flags,
                                D3D12_RESOURCE_STATES resource_state, ID3D12Resource **buffer) {
-    return CreateTexture2D(device, D3D12_HEAP_TYPE_DEFAULT, width, height, mip_levels, format,
+    return CreateTexture2D(device, D3D12_HEAP_TYPE_DEFAULT, width, height, 1, mip_levels, format,
                            flags, resource_state, nullptr, buffer);
 }
 
@@ -185,12 +196,20 @@ HRESULT CreateDefaultTexture2D(ID3D12Device *device, UINT64 width, UINT height,
                                DXGI_FORMAT format, D3D12_RESOURCE_FLAGS flags,
                                D3D12_RESOURCE_STATES resource_state, const D3D12_CLEAR_VALUE *clear_value,
                                ID3D12Resource **buffer) {
-    return CreateTexture2D(device, D3D12_HEAP_TYPE_DEFAULT, width, height, mip_levels, format,
+    return CreateTexture2D(device, D3D12_HEAP_TYPE_DEFAULT, width, height, 1, mip_levels, format,
                            flags, resource_state, clear_value, buffer);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
+HRESULT CreateDefaultTexture2DArray(ID3D12Device *device, UINT64 width, UINT height, UINT16 array_size,
+                                    UINT16 mip_levels, DXGI_FORMAT format, ID3D12Resource **buffer) {
+    return CreateTexture2D(device, D3D12_HEAP_TYPE_DEFAULT, width, height, array_size, mip_levels, format,
+                           D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_COPY_DEST, nullptr, buffer);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 DirectX::XMFLOAT4X4 XMMatrixInverse(const DirectX::XMFLOAT4X4 &float4x4) {
     XMMATRIX matrix = XMMatrixSet(float4x4._11, float4x4._12, float4x4._13, float4x4._14,
                                   float4x4._21, float4x4._22, float4x4._23, float4x4._24,
@@ -0,0 +1,249 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include "virtual_texture.h"
+
+#include <fmt/format.h>
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <stdexcept>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+constexpr UINT16 kMaxMipLevels = 16;
+constexpr UINT64 kMaxTileCount = 0x4000;
+constexpr UINT kLoadThreadCount = 4;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Check a format is block compressed or not.
+//! \param format A format.
+//! \return True if a format is block compressed.
+inline bool IsBlockCompressed(DXGI_FORMAT format) {
+    return (format >= DXGI_FORMAT_BC1_TYPELESS && format <= DXGI_FORMAT_BC5_SNORM) ||
+           (format >= DXGI_FORMAT_BC6H_TYPELESS && format <= DXGI_FORMAT_BC7_UNORM_SRGB);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+VirtualTexture::VirtualTexture(const VirtualTextureDesc &desc, UINT tile_size, UINT slot_count, TileReader reader)
+        : _desc(desc), _reader(std::move(reader)), _tile_size(tile_size) {
+    assert(_reader && _desc.element_size > 0);
+
+    // A packed tile id has a mip slice in 4 bits and the coordinates of a tile in 14 bits each.
+    if (_desc.mip_levels == 0 || _desc.mip_levels > kMaxMipLevels) {
+        throw std::runtime_error(fmt::format("Fail to create a virtual texture: {} mips don't fit to a tile id.",
+                                             _desc.mip_levels));
+    }
+
+    // Calculate the layout of a tile. A row of a block compressed format is a row of 4x4 blocks.
+    _block_dimension = IsBlockCompressed(_desc.format) ? 4 : 1;
+    if (_tile_size == 0 || _tile_size % _block_dimension) {
+        throw std::runtime_error(fmt::format("Fail to create a virtual texture: tile size must be a multiple of {}.",
+                                             _block_dimension));
+    }
+
+    _tile_row_pitch = _tile_size / _block_dimension * _desc.element_size;
+    _tile_height = _tile_size / _block_dimension;
+
+    // Initialize page tables. Every tile isn't resident.
+    for (UINT16 mip = 0; mip != _desc.mip_levels; ++mip) {
+        auto width = std::max<UINT64>(_desc.width >> mip, 1);
+        auto height = std::max<UINT>(_desc.height >> mip, 1);
+        auto count_x = (width + _tile_size - 1) / _tile_size;
+        auto count_y = (height + _tile_size - 1) / _tile_size;
+        if (count_x > kMaxTileCount || count_y > kMaxTileCount) {
+            throw std::runtime_error(fmt::format("Fail to create a virtual texture: {}x{} tiles don't fit to "
+                                                 "a tile id.", count_x, count_y));
+        }
+
+        _tile_counts.emplace_back(static_cast<UINT>(count_x), count_y);
+        _page_tables.emplace_back(count_x * count_y, kInvalidTileSlot);
+    }
+
+    // Tiles of the coarsest mip are pinned, so at least one more slot is needed to load any other tile.
+    auto [fallback_x, fallback_y] = _tile_counts.back();
+    if (slot_count <= fallback_x * fallback_y || slot_count >= kInvalidTileSlot) {
+        throw std::runtime_error(fmt::format("Fail to create a virtual texture: {} slots don't exceed {} tiles of "
+                                             "the coarsest mip.", slot_count, fallback_x * fallback_y));
+    }
+
+    // Initialize slots of the physical tile cache.
+    _slots.resize(slot_count);
+    for (auto &slot : _slots) {
+        slot.data.resize(_tile_row_pitch * _tile_height);
+    }
+
+    _thread_pool = std::make_unique<ThreadPool>(kLoadThreadCount);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+VirtualTexture::~VirtualTexture() {
+    for (auto &load : _loads) {
+        load.future.wait();
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void VirtualTexture::RequestTiles(std::span<const UINT32> feedback) {
+    for (auto packed : feedback) {
+        auto tile = UnpackTileId(packed);
+
+        // Ignore cleared or invalid entries of a feedback buffer.
+        if (tile.mip_slice >= _desc.mip_levels ||
+            tile.x >= _tile_counts[tile.mip_slice].first || tile.y >= _tile_counts[tile.mip_slice].second) {
+            continue;
+        }
+
+        // Keep a resident tile from being replaced.
+        auto slot = _page_tables[tile.mip_slice][GetPageIndex(tile)];
+        if (slot != kInvalidTileSlot) {
+            _slots[slot].last_used_frame = _frame;
+            continue;
+        }
+
+        auto &count = _requests[packed];
+        count = std::min(count, UINT_MAX - 1) + 1;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::vector<TileUpload> VirtualTexture::Update(UINT max_loads) {
+    std::vector<TileUpload> uploads;
+
+    // Map completed loads to the page table.
+    for (auto iter = _loads.begin(); iter != _loads.end();) {
+        if (iter->future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            ++iter;
+            continue;
+        }
+
+        try {
+            iter->future.get();
+        }
+        catch (const std::exception &exception) {
+            // A tile which fails to be read stays unmapped, so it is requested again by the feedback.
+            OutputDebugStringA(exception.what());
+            iter = _loads.erase(iter);
+            continue;
+        }
+
+        auto tile = UnpackTileId(iter->tile);
+        auto &slot = _slots[iter->slot];
+        slot.tile = iter->tile;
+        slot.last_used_frame = _frame;
+        slot.pinned = tile.mip_slice == _desc.mip_levels - 1;
+        _page_tables[tile.mip_slice][GetPageIndex(tile)] = iter->slot;
+        uploads.push_back({tile, iter->slot, slot.data.data(), _tile_row_pitch, _tile_height});
+
+        iter = _loads.erase(iter);
+    }
+
+    // Request the coarsest mip first, so there is always a fallback to sample.
+    RequestFallbackTiles();
+
+    // Sort requests by priority. The most requested tile is loaded first, and the coarser mip wins on a tie.
+    std::vector<std::pair<UINT32, UINT>> requests(_requests.begin(), _requests.end());
+    std::sort(requests.begin(), requests.end(), [](const auto &lhs, const auto &rhs) {
+        if (lhs.second != rhs.second) {
+            return lhs.second > rhs.second;
+        }
+        return UnpackTileId(lhs.first).mip_slice > UnpackTileId(rhs.first).mip_slice;
+    });
+
+    // Dispatch loads to worker threads.
+    for (auto &[packed, count] : requests) {
+        if (_loads.size() >= max_loads) {
+            break;
+        }
+
+        auto tile = UnpackTileId(packed);
+        if (_page_tables[tile.mip_slice][GetPageIndex(tile)] != kInvalidTileSlot) {
+            continue;
+        }
+
+        if (std::any_of(_loads.begin(), _loads.end(), [packed = packed](const auto &load) {
+            return load.tile == packed;
+        })) {
+            continue;
+        }
+
+        auto index = AcquireSlot();
+        if (index == kInvalidTileSlot) {
+            break;
+        }
+
+        // Unmap a replaced tile from the page table.
+        auto &slot = _slots[index];
+        if (slot.tile != kInvalidTileSlot) {
+            auto replaced = UnpackTileId(slot.tile);
+            _page_tables[replaced.mip_slice][GetPageIndex(replaced)] = kInvalidTileSlot;
+            slot.tile = kInvalidTileSlot;
+        }
+
+        // Texels outside of a texture are cleared before a tile is read.
+        _loads.push_back({packed, index, _thread_pool->Submit([this, tile, &slot]() {
+            std::fill(slot.data.begin(), slot.data.end(), 0);
+            _reader(tile, slot.data, _tile_row_pitch);
+        })});
+    }
+
+    _requests.clear();
+    ++_frame;
+
+    return uploads;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void VirtualTexture::RequestFallbackTiles() {
+    auto coarsest_mip = static_cast<UINT16>(_desc.mip_levels - 1);
+    auto [count_x, count_y] = _tile_counts[coarsest_mip];
+    for (UINT16 y = 0; y != count_y; ++y) {
+        for (UINT16 x = 0; x != count_x; ++x) {
+            TileId tile = {coarsest_mip, x, y};
+            if (_page_tables[coarsest_mip][GetPageIndex(tile)] == kInvalidTileSlot) {
+                _requests[PackTileId(tile)] = UINT_MAX;
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+UINT VirtualTexture::GetPageIndex(const TileId &tile) const {
+    return tile.y * _tile_counts[tile.mip_slice].first + tile.x;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+UINT32 VirtualTexture::AcquireSlot() {
+    auto victim = kInvalidTileSlot;
+    for (UINT32 i = 0; i != _slots.size(); ++i) {
+        auto &slot = _slots[i];
+
+        // Skip slots which are loading, pinned or used in this frame.
+        if (slot.pinned || (slot.last_used_frame == _frame && slot.tile != kInvalidTileSlot) ||
+            std::any_of(_loads.begin(), _loads.end(), [i](const auto &load) { return load.slot == i; })) {
+            continue;
+        }
+
+        if (slot.tile == kInvalidTileSlot) {
+            return i;
+        }
+
+        if (victim == kInvalidTileSlot || slot.last_used_frame < _slots[victim].last_used_frame) {
+            victim = i;
+        }
+    }
+
+    return victim;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,33 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include <common/archive.h>
+#include <fmt/format.h>
+#include <cstring>
+#include <vector>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char *argv[]) {
+    // Usage: packer [--compress] <archive> <directory>...
+    auto compress = argc > 1 && !strcmp(argv[1], "--compress");
+    auto first = compress ? 2 : 1;
+    if (argc - first < 2) {
+        fmt::print(stderr, "Usage: packer [--compress] <archive> <directory>...\n");
+        return 1;
+    }
+
+    try {
+        std::vector<std::filesystem::path> directories(argv + first + 1, argv + argc);
+        WriteArchive(argv[first], directories, compress);
+    }
+    catch (const std::exception &exception) {
+        fmt::print(stderr, "{}\n", exception.what());
+        return 1;
+    }
+    return 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
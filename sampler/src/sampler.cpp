@@ -7,9 +7,11 @@
 #include <common/example.h>
 #include <common/resource_uploader.h>
 #include <common/image_loader.h>
+#include <common/sampler_cache.h>
 #include <memory>
 #include <vector>
 #include <array>
+#include <stdexcept>
 
 using namespace DirectX;
 
@@ -46,8 +48,7 @@ struct Options {
 
 const std::unordered_map<D3D12_DESCRIPTOR_HEAP_TYPE, UINT> kDescriptorCount = {
         {D3D12_DESCRIPTOR_HEAP_TYPE_RTV,         kSwapChainBufferCount},
-        {D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, kImGuiFontBufferCount + 1},
-        {D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER,     1}};
+        {D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, kImGuiFontBufferCount + 1}};
 const std::vector<const char *> kFilterNames = {"MIN_MAG_MIP_POINT",
                                                 "MIN_MAG_POINT_MIP_LINEAR",
                                                 "MIN_POINT_MAG_LINEAR_MIP_POINT",
@@ -117,11 +118,10 @@ const std::vector<D3D12_TEXTURE_ADDRESS_MODE> kTextureAddressModes = {D3D12_TEXT
 
 class Sampler : public Example {
 public:
-    Sampler() : Example("Sampler", kDescriptorCount) {
+    Sampler() : Example("Sampler", kDescriptorCount), _sampler_cache(_device.Get()) {
         FileSystem::GetInstance()->AddDirectory(SAMPLER_ASSET_DIR);
 
         InitResources();
-        InitSampler();
         InitPipelines();
     }
 
@@ -152,34 +152,19 @@ protected:
 
             ImGui::Separator();
 
-            if (ImGui::Combo("Sampler filter", &_options.sampler_filter, kFilterNames.data(),
-                             static_cast<INT>(kFilterNames.size()))) {
-                WaitCommandQueueIdle();
-                InitSampler();
-            }
+            ImGui::Combo("Sampler filter", &_options.sampler_filter, kFilterNames.data(),
+                         static_cast<INT>(kFilterNames.size()));
 
-            if (ImGui::Combo("Sampler address U", &_options.sampler_address_u, kTextureAddressModeNames.data(),
-                             static_cast<INT>(kTextureAddressModeNames.size()))) {
-                WaitCommandQueueIdle();
-                InitSampler();
-            }
+            ImGui::Combo("Sampler address U", &_options.sampler_address_u, kTextureAddressModeNames.data(),
+                         static_cast<INT>(kTextureAddressModeNames.size()));
 
-            if (ImGui::Combo("Sampler address V", &_options.sampler_address_v, kTextureAddressModeNames.data(),
-                             static_cast<INT>(kTextureAddressModeNames.size()))) {
-                WaitCommandQueueIdle();
-                InitSampler();
-            }
+            ImGui::Combo("Sampler address V", &_options.sampler_address_v, kTextureAddressModeNames.data(),
+                         static_cast<INT>(kTextureAddressModeNames.size()));
 
-            if (ImGui::SliderInt("Sampler max anisotropy", &_options.sampler_max_anisotropy, 1, 16)) {
-                WaitCommandQueueIdle();
-                InitSampler();
-            }
+            ImGui::SliderInt("Sampler max anisotropy", &_options.sampler_max_anisotropy, 1, 16);
 
-            if (ImGui::ColorPicker4("Sampler border color", _options.sampler_border_color.data(),
-                                    ImGuiColorEditFlags_InputRGB | ImGuiColorEditFlags_DisplayRGB)) {
-                WaitCommandQueueIdle();
-                InitSampler();
-            }
+            ImGui::ColorPicker4("Sampler border color", _options.sampler_border_color.data(),
+                                ImGuiColorEditFlags_InputRGB | ImGuiColorEditFlags_DisplayRGB);
         }
 
         // Define transforms.
@@ -225,14 +210,16 @@ protected:
         _command_list->RSSetScissorRects(1, &_scissor_rect);
         _command_list->SetGraphicsRootSignature(_root_signature.Get());
 
+        // Retrieve a sampler of current options. A sampler is used until this frame's fence value is signaled.
+        auto sampler = _sampler_cache.GetSampler(BuildSamplerDesc(), _fence_value + 1, _fence->GetCompletedValue());
+
         ID3D12DescriptorHeap *heaps[2] = {_descriptor_heaps[D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV].Get(),
-                                          _descriptor_heaps[D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER].Get()};
+                                          _sampler_cache.GetDescriptorHeap()};
         _command_list->SetDescriptorHeaps(2, heaps);
         _command_list->SetGraphicsRootConstantBufferView(0, _constant_buffers[index]->GetGPUVirtualAddress());
         _command_list->SetGraphicsRootDescriptorTable(1,
                                                       _descriptor_heaps[D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV]->GetGPUDescriptorHandleForHeapStart());
-        _command_list->SetGraphicsRootDescriptorTable(2,
-                                                      _descriptor_heaps[D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER]->GetGPUDescriptorHandleForHeapStart());
+        _command_list->SetGraphicsRootDescriptorTable(2, _sampler_cache.GetGPUHandle(sampler));
         _command_list->SetPipelineState(_pipeline_state.Get());
         _command_list->IASetVertexBuffers(0, 1, &_vertex_buffer_view);
         _command_list->IASetIndexBuffer(&_index_buffer_view);
@@ -278,10 +265,7 @@ private:
         // Initialize a texture.
         ThrowIfFailed(CreateDefaultTexture2D(_device.Get(), image.width, image.height,
                                              image.mip_levels, image.format, &_texture));
-        for (auto i = 0; i != image.mip_levels; ++i) {
-            auto &subresource = image.subresources[i];
-            uploader.RecordCopyData(_texture.Get(), i, subresource.data, subresource.row_pitch * subresource.height);
-        }
+        uploader.RecordCopyData(_texture.Get(), image);
 
         uploader.Execute();
 
@@ -305,7 +289,8 @@ private:
                                           _descriptor_heaps[D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV]->GetCPUDescriptorHandleForHeapStart());
     }
 
-    void InitSampler() {
+    [[nodiscard]]
+    D3D12_SAMPLER_DESC BuildSamplerDesc() const {
         D3D12_SAMPLER_DESC desc = {};
         desc.Filter = kFilters[_options.sampler_filter];
         desc.AddressU = kTextureAddressModes[_options.sampler_address_u];
@@ -315,9 +300,7 @@ private:
         memcpy(desc.BorderColor, _options.sampler_border_color.data(), sizeof(float) * 4);
         desc.MaxLOD = D3D12_FLOAT32_MAX;
 
-        CD3DX12_CPU_DESCRIPTOR_HANDLE cpu_handle(
-                _descriptor_heaps[D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER]->GetCPUDescriptorHandleForHeapStart());
-        _device->CreateSampler(&desc, cpu_handle);
+        return desc;
     }
 
     void InitPipelines() {
@@ -343,15 +326,21 @@ private:
                                                         D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 
         // Create a root signature.
-        ThrowIfFailed(CreateRootSignature(_device.Get(), &root_signature_desc, &_root_signature));
-
-        // Compile a vertex shader.
-        ComPtr<ID3DBlob> vertex_shader;
-        ThrowIfFailed(CompileShader("unlit.hlsl", "VSMain", "vs_5_0", &vertex_shader));
+        ThrowIfFailed(_pipeline_cache->CreateRootSignature(root_signature_desc, &_root_signature));
+
+        // Compile a vertex shader and a pixel shader concurrently.
+        std::array<ShaderRequest, 2> requests = {{
+                {"unlit.hlsl", L"VSMain", L"vs_6_0"},
+                {"unlit.hlsl", L"PSMain", L"ps_6_0"}}};
+        auto shaders = _compiler.CompileShaders(requests);
+        for (auto &shader : shaders) {
+            if (FAILED(shader.result)) {
+                throw std::runtime_error(shader.diagnostics);
+            }
+        }
 
-        // Compile a pixel shader.
-        ComPtr<ID3DBlob> pixel_shader;
-        ThrowIfFailed(CompileShader("unlit.hlsl", "PSMain", "ps_5_0", &pixel_shader));
+        auto &vertex_shader = shaders[0].code;
+        auto &pixel_shader = shaders[1].code;
 
         // Define a graphics pipeline state.
         D3D12_GRAPHICS_PIPELINE_STATE_DESC desc = {};
@@ -371,7 +360,7 @@ private:
         desc.SampleDesc = {1, 0};
 
         // Create a graphics pipeline state.
-        ThrowIfFailed(_device->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(&_pipeline_state)));
+        ThrowIfFailed(_pipeline_cache->CreateGraphicsPipelineState(desc, &_pipeline_state));
     }
 
 private:
@@ -386,6 +375,7 @@ private:
     ComPtr<ID3D12PipelineState> _pipeline_state;
     D3D12_VIEWPORT _viewport = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f};
     D3D12_RECT _scissor_rect = {0, 0, 0, 0};
+    SamplerCache _sampler_cache;
 };
 
 //----------------------------------------------------------------------------------------------------------------------
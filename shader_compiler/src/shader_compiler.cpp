@@ -0,0 +1,116 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include <common/compiler.h>
+#include <common/file_system.h>
+#include <common/utility.h>
+#include <fmt/format.h>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Parse a declaration of a shader.
+//! \param declaration A declaration in the form of "<path>:<entrypoint>:<target>". A library has no entrypoint.
+//! \return A request.
+ShaderRequest ParseRequest(const std::string &declaration) {
+    auto first = declaration.find(':');
+    auto second = first != std::string::npos ? declaration.find(':', first + 1) : std::string::npos;
+    if (second == std::string::npos) {
+        throw std::runtime_error(fmt::format("Fail to parse {}.", declaration));
+    }
+
+    return {ConvertUTF8ToUTF16(declaration.substr(0, first).c_str()),
+            ConvertUTF8ToUTF16(declaration.substr(first + 1, second - first - 1).c_str()),
+            ConvertUTF8ToUTF16(declaration.substr(second + 1).c_str()),
+            {}};
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Generate a source which embeds compiled shaders. Shaders are registered with their cache keys,
+//! so the compiler finds them without loading DLLs.
+//! \param results Compiled shaders.
+//! \return A source.
+std::string GenerateSource(const std::vector<ShaderResult> &results) {
+    std::string source = "// Generated by shader_compiler. Don't edit.\n\n"
+                         "#include <common/embedded_shader.h>\n\n"
+                         "namespace {\n\n";
+
+    for (size_t i = 0; i != results.size(); ++i) {
+        auto data = static_cast<const BYTE *>(results[i].code->GetBufferPointer());
+        auto size = results[i].code->GetBufferSize();
+
+        source += fmt::format("constexpr BYTE kCode{}[] = {{", i);
+        for (size_t j = 0; j != size; ++j) {
+            source += fmt::format("{}0x{:02x},", j % 16 ? " " : "\n    ", data[j]);
+        }
+        source += "\n};\n\n";
+
+        // Dependencies are a list of paths which ends with an empty path.
+        source += fmt::format("constexpr char kDependencies{}[] = \"", i);
+        for (auto &dependency : results[i].dependencies) {
+            for (auto c : dependency.generic_u8string()) {
+                source += fmt::format("\\x{:02x}", static_cast<unsigned char>(c));
+            }
+            source += "\\0";
+        }
+        source += "\";\n\n";
+    }
+
+    source += "const EmbeddedShader kShaders[] = {\n";
+    for (size_t i = 0; i != results.size(); ++i) {
+        source += fmt::format("    {{0x{:016x}ull, kCode{}, sizeof(kCode{}), kDependencies{}}},\n",
+                              results[i].key, i, i, i);
+    }
+    source += "};\n\n"
+              "const bool kRegistered = (RegisterEmbeddedShaders(kShaders), true);\n\n"
+              "} // namespace\n";
+
+    return source;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char *argv[]) {
+    // Usage: shader_compiler <output> <directory> <path>:<entrypoint>:<target>...
+    if (argc < 4) {
+        fmt::print(stderr, "Usage: shader_compiler <output> <directory> <path>:<entrypoint>:<target>...\n");
+        return 1;
+    }
+
+    try {
+        // Sources are resolved like examples resolve them, so keys match at runtime.
+        FileSystem::GetInstance()->AddDirectory(argv[2]);
+
+        std::vector<ShaderRequest> requests;
+        for (auto i = 3; i != argc; ++i) {
+            requests.push_back(ParseRequest(argv[i]));
+        }
+
+        Compiler compiler;
+        auto results = compiler.CompileShaders(requests);
+        for (size_t i = 0; i != results.size(); ++i) {
+            if (FAILED(results[i].result)) {
+                throw std::runtime_error(fmt::format("Fail to compile {}.\n{}", argv[i + 3], results[i].diagnostics));
+            }
+        }
+
+        std::ofstream fout(argv[1], std::ios::out | std::ios::trunc);
+        if (!fout.is_open()) {
+            throw std::runtime_error(fmt::format("Fail to open {}.", argv[1]));
+        }
+        fout << GenerateSource(results);
+    }
+    catch (const std::exception &exception) {
+        fmt::print(stderr, "{}\n", exception.what());
+        return 1;
+    }
+    return 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
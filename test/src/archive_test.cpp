@@ -0,0 +1,172 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/archive.h"
+#include "test.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Write a file and its parent directories.
+//! \param path A file path.
+//! \param contents The contents of a file.
+void WriteFile(const std::filesystem::path &path, const std::vector<BYTE> &contents) {
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream fout(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    fout.write(reinterpret_cast<const char *>(contents.data()), static_cast<std::streamsize>(contents.size()));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Expect that an archive has an entry of the given contents.
+//! \param archive An archive.
+//! \param path A relative file path.
+//! \param contents The contents of an entry.
+//! \param compressed True if an entry must be compressed.
+void ExpectEntry(const Archive &archive, const std::filesystem::path &path, const std::vector<BYTE> &contents,
+                 bool compressed) {
+    auto entry = archive.FindEntry(path);
+    Expect(entry != nullptr);
+    if (entry) {
+        Expect(entry->size == contents.size());
+        Expect(((entry->flags & kArchiveEntryCompressed) != 0) == compressed);
+        Expect(entry->offset % kArchiveAlignment == 0);
+        Expect(archive.ReadEntry(*entry) == contents);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Corrupt a copy of an archive and expect that mounting it throws.
+//! \param source The path of a valid archive.
+//! \param path The path of a corrupt copy.
+//! \param corrupt A function which modifies a header and the first entry which is stored as is.
+template<typename Function>
+void ExpectCorruptThrows(const std::filesystem::path &source, const std::filesystem::path &path, Function corrupt) {
+    std::ifstream fin(source, std::ios::in | std::ios::binary);
+    std::vector<BYTE> data{std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>()};
+
+    ArchiveHeader header;
+    memcpy(&header, data.data(), sizeof(header));
+
+    // Find a non-empty entry which isn't compressed.
+    size_t entry_offset = 0;
+    ArchiveEntry entry = {};
+    for (UINT32 i = 0; i != header.entry_count; ++i) {
+        entry_offset = header.toc_offset + i * sizeof(ArchiveEntry);
+        memcpy(&entry, data.data() + entry_offset, sizeof(entry));
+        if (entry.size && !(entry.flags & kArchiveEntryCompressed)) {
+            break;
+        }
+    }
+
+    corrupt(header, entry);
+    memcpy(data.data(), &header, sizeof(header));
+    memcpy(data.data() + entry_offset, &entry, sizeof(entry));
+
+    WriteFile(path, data);
+    ExpectThrow(Archive archive(path));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int main() {
+    auto root = std::filesystem::temp_directory_path() / "directx12_archive_test";
+    std::filesystem::remove_all(root);
+
+    std::mt19937 engine(20240101);
+    std::uniform_int_distribution<UINT> distribution(0, 255);
+    std::vector<BYTE> random(10000);
+    for (auto &byte : random) {
+        byte = static_cast<BYTE>(distribution(engine));
+    }
+
+    std::string text;
+    while (text.size() < 20000) {
+        text += "struct VertexOutput { float4 position : SV_POSITION; float2 uv : TEXCOORD; };\n";
+    }
+
+    std::vector<BYTE> compressible(text.begin(), text.end());
+    std::vector<BYTE> shadowed = {'b', 'a', 's', 'e'};
+    std::vector<BYTE> overriding = {'m', 'o', 'd'};
+
+    // A file of the former directory wins when paths are duplicated.
+    WriteFile(root / "mod" / "config.txt", overriding);
+    WriteFile(root / "base" / "config.txt", shadowed);
+    WriteFile(root / "base" / "shader" / "triangle.hlsl", compressible);
+    WriteFile(root / "base" / "texture" / "noise.bin", random);
+    WriteFile(root / "base" / "empty.txt", {});
+
+    const std::filesystem::path directories[] = {root / "mod", root / "base"};
+    for (auto compress : {true, false}) {
+        auto path = root / (compress ? "compressed.pak" : "stored.pak");
+        WriteArchive(path, directories, compress);
+
+        Archive archive(path);
+        ExpectEntry(archive, "config.txt", overriding, false);
+        ExpectEntry(archive, "shader/triangle.hlsl", compressible, compress);
+        ExpectEntry(archive, "texture/noise.bin", random, false);
+        ExpectEntry(archive, "empty.txt", {}, false);
+
+        // A path is normalized before it is found.
+        ExpectEntry(archive, "shader/../texture/./noise.bin", random, false);
+        Expect(archive.FindEntry("missing.txt") == nullptr);
+        Expect(archive.FindEntry("shader") == nullptr);
+    }
+
+    // An entry which is stored as is must have its size, otherwise it would be copied past a buffer.
+    constexpr auto kMax = std::numeric_limits<UINT64>::max();
+    auto stored = root / "stored.pak";
+    auto corrupt = root / "corrupt.pak";
+    ExpectCorruptThrows(stored, corrupt, [](auto &, auto &entry) { entry.stored_size = entry.size + 1; });
+    ExpectCorruptThrows(stored, corrupt, [](auto &, auto &entry) { entry.stored_size = entry.size - 1; });
+
+    // Offsets which wrap around the end of an archive are rejected.
+    ExpectCorruptThrows(stored, corrupt, [](auto &header, auto &) { header.toc_offset = kMax - 7; });
+    ExpectCorruptThrows(stored, corrupt, [](auto &header, auto &) { header.names_offset = kMax - 7; });
+    ExpectCorruptThrows(stored, corrupt, [](auto &, auto &entry) { entry.offset = kMax - entry.stored_size + 2; });
+    ExpectCorruptThrows(stored, corrupt, [](auto &, auto &entry) {
+        entry.offset = kArchiveAlignment;
+        entry.size = kMax;
+        entry.stored_size = kMax;
+    });
+    ExpectCorruptThrows(stored, corrupt, [](auto &header, auto &entry) {
+        entry.name_offset = header.names_size;
+        entry.name_size = 1;
+    });
+
+    // A table of contents is used in place, so it must be aligned.
+    ExpectCorruptThrows(stored, corrupt, [](auto &header, auto &) { header.toc_offset -= 1; });
+
+    // A truncated archive is rejected when it is mounted.
+    {
+        auto path = root / "compressed.pak";
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+        ExpectThrow(Archive archive(path));
+
+        std::filesystem::resize_file(path, sizeof(ArchiveHeader) - 1);
+        ExpectThrow(Archive archive(path));
+    }
+
+    // A file which isn't an archive is rejected.
+    {
+        auto path = root / "base" / "shader" / "triangle.hlsl";
+        ExpectThrow(Archive archive(path));
+    }
+
+    std::filesystem::remove_all(root);
+
+    return GetExitCode();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,143 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include <iterator>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "common/compression.h"
+#include "test.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Compress data and expect that it is decompressed to the same data.
+//! \param src Data.
+//! \return Compressed data.
+std::vector<BYTE> ExpectRoundTrip(const std::vector<BYTE> &src) {
+    auto compressed = CompressLZ4(src);
+
+    // The worst case grows by a length byte per 255 literals and a token.
+    Expect(compressed.size() <= src.size() + src.size() / 255 + 16);
+
+    std::vector<BYTE> decompressed(src.size());
+    DecompressLZ4(compressed, decompressed);
+    Expect(decompressed == src);
+
+    return compressed;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Build random bytes which are incompressible.
+//! \param size The number of bytes.
+//! \param engine A random engine.
+//! \return Bytes.
+std::vector<BYTE> BuildRandomBytes(size_t size, std::mt19937 &engine) {
+    std::uniform_int_distribution<UINT> distribution(0, 255);
+    std::vector<BYTE> bytes(size);
+    for (auto &byte : bytes) {
+        byte = static_cast<BYTE>(distribution(engine));
+    }
+    return bytes;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Build text which repeats words, so it has many short matches.
+//! \param size The number of bytes.
+//! \param engine A random engine.
+//! \return Bytes.
+std::vector<BYTE> BuildText(size_t size, std::mt19937 &engine) {
+    constexpr std::string_view kWords[] = {"vertex ", "pixel ", "shader ", "texture ", "sampler ", "buffer ", "\n"};
+
+    std::uniform_int_distribution<size_t> distribution(0, std::size(kWords) - 1);
+    std::vector<BYTE> bytes;
+    while (bytes.size() < size) {
+        auto word = kWords[distribution(engine)];
+        bytes.insert(bytes.end(), word.begin(), word.end());
+    }
+    bytes.resize(size);
+    return bytes;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int main() {
+    std::mt19937 engine(20240101);
+
+    // An empty input is a single token without literals.
+    {
+        auto compressed = ExpectRoundTrip({});
+        Expect(compressed.size() == 1);
+    }
+
+    // Inputs around the limit of the last match are stored as literals or have a single match.
+    for (size_t size = 1; size != 32; ++size) {
+        ExpectRoundTrip(std::vector<BYTE>(size, 0x41));
+        ExpectRoundTrip(BuildRandomBytes(size, engine));
+    }
+
+    // Incompressible data is stored as literals, whose length crosses many length bytes.
+    ExpectRoundTrip(BuildRandomBytes(1 << 20, engine));
+
+    // Long matches overlap with themselves and have long lengths.
+    for (auto period : {1, 2, 3, 7, 64, 65535}) {
+        std::vector<BYTE> src(1 << 20);
+        auto pattern = BuildRandomBytes(period, engine);
+        for (size_t i = 0; i != src.size(); ++i) {
+            src[i] = pattern[i % period];
+        }
+
+        auto compressed = ExpectRoundTrip(src);
+        Expect(compressed.size() < period + src.size() / 100);
+    }
+
+    // Matches which are farther than the maximum offset aren't used.
+    {
+        auto block = BuildRandomBytes(70000, engine);
+        auto src = block;
+        src.insert(src.end(), block.begin(), block.end());
+        ExpectRoundTrip(src);
+    }
+
+    auto text = BuildText(100000, engine);
+    auto compressed = ExpectRoundTrip(text);
+    Expect(compressed.size() < text.size() / 2);
+
+    // A truncated stream never decompresses to the full size.
+    std::vector<BYTE> decompressed(text.size());
+    for (auto size : {compressed.size() - 1, compressed.size() - 2, compressed.size() / 2, size_t(1), size_t(0)}) {
+        ExpectThrow(DecompressLZ4(std::span(compressed).first(size), decompressed));
+    }
+
+    // A wrong size is detected.
+    std::vector<BYTE> smaller(text.size() - 1);
+    std::vector<BYTE> larger(text.size() + 1);
+    ExpectThrow(DecompressLZ4(compressed, smaller));
+    ExpectThrow(DecompressLZ4(compressed, larger));
+
+    // A match before the start of the output is detected.
+    const BYTE zero_offset[] = {0x10, 0x41, 0x00, 0x00, 0x00};
+    const BYTE far_offset[] = {0x10, 0x41, 0x02, 0x00, 0x00};
+    std::vector<BYTE> output(5);
+    ExpectThrow(DecompressLZ4(zero_offset, output));
+    ExpectThrow(DecompressLZ4(far_offset, output));
+
+    // A corrupted stream throws or decompresses to wrong data, but it never accesses memory out of bounds.
+    for (auto i = 0; i != 10000; ++i) {
+        auto corrupted = compressed;
+        auto position = std::uniform_int_distribution<size_t>(0, corrupted.size() - 1)(engine);
+        corrupted[position] ^= static_cast<BYTE>(std::uniform_int_distribution<UINT>(1, 255)(engine));
+        try {
+            DecompressLZ4(corrupted, decompressed);
+        } catch (const std::exception &) {
+        }
+    }
+
+    return GetExitCode();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
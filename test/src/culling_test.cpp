@@ -0,0 +1,268 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "culling.h"
+#include "test.h"
+
+using namespace DirectX;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Counts which cover an empty input, partial and full groups of 8 and tails of every length.
+constexpr size_t kCounts[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 12, 15, 16, 17, 31, 33, 63, 64, 65, 1000, 1001, 1007};
+
+//! The number of objects of a benchmark.
+constexpr size_t kBenchmarkCount = 1 << 20;
+
+//! A guard byte after a mask, which must not be overwritten.
+constexpr BYTE kGuard = 0xA5;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Build a perspective frustum whose field of view is 90 degrees, looking at +z.
+//! \return A frustum.
+Frustum BuildPerspectiveFrustum() {
+    constexpr float kNear = 0.1f;
+    constexpr float kFar = 100.0f;
+
+    XMFLOAT4X4 m = {};
+    m._11 = 1.0f;
+    m._22 = 1.0f;
+    m._33 = kFar / (kFar - kNear);
+    m._34 = 1.0f;
+    m._43 = -kNear * kFar / (kFar - kNear);
+
+    return ExtractFrustum(m);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Build an orthographic frustum. Planes have zero components, so an infinite extent makes NaN.
+//! \return A frustum.
+Frustum BuildOrthographicFrustum() {
+    XMFLOAT4X4 m = {};
+    m._11 = 1.0f / 50.0f;
+    m._22 = 1.0f / 50.0f;
+    m._33 = 1.0f / 100.0f;
+    m._44 = 1.0f;
+
+    return ExtractFrustum(m);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Build values where a few are replaced by NaN, infinity or negative zero.
+//! \param count The number of values.
+//! \param min The minimum of a value.
+//! \param max The maximum of a value.
+//! \param engine A random engine.
+//! \return Values.
+std::vector<float> BuildValues(size_t count, float min, float max, std::mt19937 &engine) {
+    constexpr float kSpecials[] = {std::numeric_limits<float>::quiet_NaN(), -std::numeric_limits<float>::quiet_NaN(),
+                                   std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(),
+                                   -0.0f, 0.0f};
+
+    std::uniform_real_distribution<float> distribution(min, max);
+    std::uniform_int_distribution<size_t> special(0, 31);
+    std::vector<float> values(count);
+    for (auto &value : values) {
+        auto index = special(engine);
+        value = index < std::size(kSpecials) ? kSpecials[index] : distribution(engine);
+    }
+
+    return values;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Expect that a mask matches a scalar test and that bits and bytes after the last object are untouched.
+//! \param mask A mask which has a guard byte at the end.
+//! \param count The number of objects.
+//! \param is_visible A scalar test of an object.
+template<typename Function>
+void ExpectMatchScalar(const std::vector<BYTE> &mask, size_t count, Function is_visible) {
+    for (size_t i = 0; i != count; ++i) {
+        Expect(((mask[i / 8] >> (i % 8)) & 1) == is_visible(i));
+    }
+
+    if (count % 8) {
+        Expect((mask[count / 8] >> (count % 8)) == 0);
+    }
+
+    Expect(mask.back() == kGuard);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Test boxes against a frustum and expect the same result as the scalar test.
+//! \param frustum A frustum.
+//! \param count The number of boxes.
+//! \param engine A random engine.
+void ExpectBoxesMatchScalar(const Frustum &frustum, size_t count, std::mt19937 &engine) {
+    auto center_x = BuildValues(count, -120.0f, 120.0f, engine);
+    auto center_y = BuildValues(count, -120.0f, 120.0f, engine);
+    auto center_z = BuildValues(count, -20.0f, 120.0f, engine);
+    auto extent_x = BuildValues(count, 0.0f, 10.0f, engine);
+    auto extent_y = BuildValues(count, 0.0f, 10.0f, engine);
+    auto extent_z = BuildValues(count, 0.0f, 10.0f, engine);
+    BoundingBoxes boxes = {center_x.data(), center_y.data(), center_z.data(),
+                           extent_x.data(), extent_y.data(), extent_z.data(), count};
+
+    // Stale bits must be cleared, so a mask is filled before culling.
+    std::vector<BYTE> mask((count + 7) / 8 + 1, kGuard);
+    CullBoxes(frustum, boxes, mask.data());
+    ExpectMatchScalar(mask, count, [&](size_t i) { return IsBoxVisible(frustum, boxes, i); });
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Test spheres against a frustum and expect the same result as the scalar test.
+//! \param frustum A frustum.
+//! \param count The number of spheres.
+//! \param engine A random engine.
+void ExpectSpheresMatchScalar(const Frustum &frustum, size_t count, std::mt19937 &engine) {
+    auto center_x = BuildValues(count, -120.0f, 120.0f, engine);
+    auto center_y = BuildValues(count, -120.0f, 120.0f, engine);
+    auto center_z = BuildValues(count, -20.0f, 120.0f, engine);
+    auto radius = BuildValues(count, 0.0f, 10.0f, engine);
+    BoundingSpheres spheres = {center_x.data(), center_y.data(), center_z.data(), radius.data(), count};
+
+    std::vector<BYTE> mask((count + 7) / 8 + 1, kGuard);
+    CullSpheres(frustum, spheres, mask.data());
+    ExpectMatchScalar(mask, count, [&](size_t i) { return IsSphereVisible(frustum, spheres, i); });
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Expect that objects which are obviously inside or outside are classified, and NaN is culled.
+//! \param frustum A perspective frustum looking at +z.
+void ExpectClassify(const Frustum &frustum) {
+    constexpr auto kNaN = std::numeric_limits<float>::quiet_NaN();
+    constexpr auto kInfinity = std::numeric_limits<float>::infinity();
+
+    // Inside, behind, beyond the far plane, straddling the left plane, NaN and a point. An infinite box is culled,
+    // because a zero plane component times an infinite extent is NaN, but an infinite sphere is visible.
+    const float center_x[] = {0.0f, 0.0f, 0.0f, -12.0f, kNaN, 0.0f, 0.0f, 0.0f, 0.0f};
+    const float center_y[] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, kNaN, 0.0f};
+    const float center_z[] = {10.0f, -10.0f, 200.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f};
+    const float extent[] = {1.0f, 1.0f, 1.0f, 3.0f, 1.0f, kNaN, kInfinity, 1.0f, 0.0f};
+    const bool box_expected[] = {true, false, false, true, false, false, false, false, true};
+    const bool sphere_expected[] = {true, false, false, true, false, false, true, false, true};
+    constexpr auto kCount = std::size(box_expected);
+
+    BoundingBoxes boxes = {center_x, center_y, center_z, extent, extent, extent, kCount};
+    BoundingSpheres spheres = {center_x, center_y, center_z, extent, kCount};
+
+    BYTE box_mask[2] = {};
+    BYTE sphere_mask[2] = {};
+    CullBoxes(frustum, boxes, box_mask);
+    CullSpheres(frustum, spheres, sphere_mask);
+    for (size_t i = 0; i != kCount; ++i) {
+        Expect(((box_mask[i / 8] >> (i % 8)) & 1) == box_expected[i]);
+        Expect(((sphere_mask[i / 8] >> (i % 8)) & 1) == sphere_expected[i]);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Measure the best time of a function over a few runs.
+//! \param function A function.
+//! \return The best time in nanoseconds.
+template<typename Function>
+double MeasureBest(Function function) {
+    constexpr auto kRunCount = 10;
+
+    auto best = std::numeric_limits<double>::max();
+    for (auto run = 0; run != kRunCount; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+
+    return best;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Compare vectorized culling with the scalar test for a million objects.
+//! \param frustum A frustum.
+//! \param engine A random engine.
+void RunBenchmark(const Frustum &frustum, std::mt19937 &engine) {
+    auto count = kBenchmarkCount;
+    std::uniform_real_distribution<float> position(-120.0f, 120.0f);
+    std::uniform_real_distribution<float> size(0.0f, 10.0f);
+    std::vector<float> values[7];
+    for (auto i = 0; i != 7; ++i) {
+        values[i].resize(count);
+        for (auto &value : values[i]) {
+            value = i < 3 ? position(engine) : size(engine);
+        }
+    }
+
+    BoundingBoxes boxes = {values[0].data(), values[1].data(), values[2].data(),
+                           values[3].data(), values[4].data(), values[5].data(), count};
+    BoundingSpheres spheres = {values[0].data(), values[1].data(), values[2].data(), values[6].data(), count};
+    std::vector<BYTE> mask((count + 7) / 8);
+
+    auto report = [&](const char *name, double time) {
+        std::printf("%-16s %8.3f ms %6.3f ns/object\n", name, time / 1e6, time / static_cast<double>(count));
+    };
+
+    report("CullBoxes", MeasureBest([&] { CullBoxes(frustum, boxes, mask.data()); }));
+    report("IsBoxVisible", MeasureBest([&] {
+        for (size_t i = 0; i < count; i += 8) {
+            BYTE bits = 0;
+            for (size_t j = i; j != std::min(i + 8, count); ++j) {
+                bits |= static_cast<BYTE>(IsBoxVisible(frustum, boxes, j) << (j - i));
+            }
+            mask[i / 8] = bits;
+        }
+    }));
+    report("CullSpheres", MeasureBest([&] { CullSpheres(frustum, spheres, mask.data()); }));
+    report("IsSphereVisible", MeasureBest([&] {
+        for (size_t i = 0; i < count; i += 8) {
+            BYTE bits = 0;
+            for (size_t j = i; j != std::min(i + 8, count); ++j) {
+                bits |= static_cast<BYTE>(IsSphereVisible(frustum, spheres, j) << (j - i));
+            }
+            mask[i / 8] = bits;
+        }
+    }));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char *argv[]) {
+    std::mt19937 engine(20240101);
+
+    auto perspective = BuildPerspectiveFrustum();
+    auto orthographic = BuildOrthographicFrustum();
+
+    // A benchmark isn't a part of the test, so it is only run on request.
+    if (argc > 1 && std::string_view(argv[1]) == "--benchmark") {
+        RunBenchmark(perspective, engine);
+        return EXIT_SUCCESS;
+    }
+
+    ExpectClassify(perspective);
+
+    for (auto &frustum : {perspective, orthographic}) {
+        for (auto count : kCounts) {
+            ExpectBoxesMatchScalar(frustum, count, engine);
+            ExpectSpheresMatchScalar(frustum, count, engine);
+        }
+    }
+
+    return GetExitCode();
+}
\ No newline at end of file
@@ -0,0 +1,121 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+#include <thread>
+
+#include "common/file_system.h"
+#include "common/hot_reload.h"
+#include "test.h"
+
+using namespace std::chrono_literals;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! The time to wait for a change to be reported and rebuilt. It is much longer than the quiet time of a change.
+constexpr auto kSettleTime = 1s;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Write a file.
+//! \param path A file path.
+//! \param contents The contents of a file.
+void WriteFile(const std::filesystem::path &path, std::string_view contents) {
+    std::ofstream fout(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    fout.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Update hot reload and apply rebuilt objects for a while, like frames do.
+//! \param hot_reload Hot reload.
+//! \param duration The time to update for.
+void UpdateFor(HotReload *hot_reload, std::chrono::milliseconds duration) {
+    auto end = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < end) {
+        if (hot_reload->Update()) {
+            hot_reload->Apply();
+        }
+        std::this_thread::sleep_for(10ms);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int main() {
+    auto root = (std::filesystem::temp_directory_path() / "directx12_hot_reload_test").lexically_normal();
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root);
+
+    // Files are found in the test directory first, so names never resolve to assets of examples.
+    for (auto name : {"reload_a.hlsl", "reload_b.hlsl", "reload_common.hlsli", "reload_extra.hlsli", "unused.txt"}) {
+        WriteFile(root / name, "// A source.");
+    }
+    FileSystem::GetInstance()->AddDirectory(root, 1);
+
+    UINT swap_counts[2] = {};
+    auto build = [&swap_counts](UINT index) {
+        return [&swap_counts, index]() -> HotReload::Swap {
+            return [&swap_counts, index]() {
+                ++swap_counts[index];
+            };
+        };
+    };
+
+    {
+        HotReload hot_reload;
+        auto a = hot_reload.Register({"reload_a.hlsl", "reload_common.hlsli"}, build(0));
+        hot_reload.Register({"reload_b.hlsl", "reload_common.hlsli"}, build(1));
+        hot_reload.Start(std::span(&root, 1));
+
+        // A burst of writes by a single save is rebuilt once.
+        for (auto i = 0; i != 5; ++i) {
+            WriteFile(root / "reload_a.hlsl", "// A modified source.");
+            std::this_thread::sleep_for(20ms);
+        }
+        UpdateFor(&hot_reload, kSettleTime);
+        Expect(swap_counts[0] == 1 && swap_counts[1] == 0);
+
+        // A shared include rebuilds every dependent which includes it.
+        WriteFile(root / "reload_common.hlsli", "// A modified include.");
+        UpdateFor(&hot_reload, kSettleTime);
+        Expect(swap_counts[0] == 2 && swap_counts[1] == 1);
+
+        // A file which isn't a dependency rebuilds nothing.
+        WriteFile(root / "unused.txt", "A modified file.");
+        UpdateFor(&hot_reload, kSettleTime);
+        Expect(swap_counts[0] == 2 && swap_counts[1] == 1);
+
+        // Replaced dependencies, like includes of the last compile, unmap the files which are no longer included.
+        hot_reload.SetDependencies(a, {"reload_a.hlsl", "reload_extra.hlsli"});
+        WriteFile(root / "reload_common.hlsli", "// An include which is modified again.");
+        UpdateFor(&hot_reload, kSettleTime);
+        Expect(swap_counts[0] == 2 && swap_counts[1] == 2);
+
+        WriteFile(root / "reload_extra.hlsli", "// A modified include.");
+        UpdateFor(&hot_reload, kSettleTime);
+        Expect(swap_counts[0] == 3 && swap_counts[1] == 2);
+
+        // A directory, which a watcher reports when its changes are lost, rebuilds every dependent under it.
+        hot_reload.Invalidate(root);
+        UpdateFor(&hot_reload, kSettleTime);
+        Expect(swap_counts[0] == 4 && swap_counts[1] == 3);
+
+        // A directory which only shares a prefix of a name doesn't contain dependencies.
+        hot_reload.Invalidate(root.parent_path() / "directx12_hot_reload");
+        hot_reload.Invalidate(root / "missing");
+        UpdateFor(&hot_reload, kSettleTime);
+        Expect(swap_counts[0] == 4 && swap_counts[1] == 3);
+    }
+
+    std::filesystem::remove_all(root);
+
+    return GetExitCode();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,319 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "common/image_loader.h"
+#include "common/pixel_conversion.h"
+#include "test.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Build the table of CRC-32 which PNG chunks use.
+//! \return A table.
+std::array<UINT32, 256> BuildCRCTable() {
+    std::array<UINT32, 256> table = {};
+    for (UINT32 i = 0; i != 256; ++i) {
+        auto value = i;
+        for (auto bit = 0; bit != 8; ++bit) {
+            value = value & 1 ? 0xEDB88320 ^ (value >> 1) : value >> 1;
+        }
+        table[i] = value;
+    }
+    return table;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Append a big endian value.
+//! \param bytes Bytes.
+//! \param value A value.
+void AppendBigEndian(std::vector<BYTE> &bytes, UINT32 value) {
+    for (auto shift : {24, 16, 8, 0}) {
+        bytes.push_back(static_cast<BYTE>(value >> shift));
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Append a PNG chunk.
+//! \param png PNG bytes.
+//! \param type The type of a chunk.
+//! \param data The data of a chunk.
+void AppendChunk(std::vector<BYTE> &png, std::string_view type, const std::vector<BYTE> &data) {
+    static const auto kCRCTable = BuildCRCTable();
+
+    AppendBigEndian(png, static_cast<UINT32>(data.size()));
+    auto begin = png.size();
+    png.insert(png.end(), type.begin(), type.end());
+    png.insert(png.end(), data.begin(), data.end());
+
+    UINT32 crc = 0xFFFFFFFF;
+    for (auto i = begin; i != png.size(); ++i) {
+        crc = kCRCTable[(crc ^ png[i]) & 0xFF] ^ (crc >> 8);
+    }
+    AppendBigEndian(png, crc ^ 0xFFFFFFFF);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Write 8 bit pixels to a PNG file. Rows are stored in uncompressed deflate blocks, so no compressor is needed.
+//! \param path A file path.
+//! \param width The width of an image.
+//! \param height The height of an image.
+//! \param components 3 for RGB or 4 for RGBA.
+//! \param pixels Pixels.
+void WritePNG(const std::filesystem::path &path, UINT width, UINT height, UINT components,
+              const std::vector<BYTE> &pixels) {
+    std::vector<BYTE> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+    std::vector<BYTE> header;
+    AppendBigEndian(header, width);
+    AppendBigEndian(header, height);
+    header.insert(header.end(), {8, static_cast<BYTE>(components == 4 ? 6 : 2), 0, 0, 0});
+    AppendChunk(png, "IHDR", header);
+
+    // Each row starts with the filter type of none.
+    std::vector<BYTE> rows;
+    auto row_size = width * components;
+    for (UINT y = 0; y != height; ++y) {
+        rows.push_back(0);
+        rows.insert(rows.end(), pixels.begin() + y * row_size, pixels.begin() + (y + 1) * row_size);
+    }
+
+    std::vector<BYTE> stream = {0x78, 0x01};
+    for (size_t offset = 0; offset < rows.size(); offset += 65535) {
+        auto size = static_cast<UINT16>(std::min<size_t>(65535, rows.size() - offset));
+        stream.push_back(offset + size == rows.size() ? 1 : 0);
+        stream.insert(stream.end(), {static_cast<BYTE>(size), static_cast<BYTE>(size >> 8),
+                                     static_cast<BYTE>(~size), static_cast<BYTE>(~size >> 8)});
+        stream.insert(stream.end(), rows.begin() + offset, rows.begin() + offset + size);
+    }
+
+    UINT32 a = 1, b = 0;
+    for (auto byte : rows) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    AppendBigEndian(stream, (b << 16) | a);
+    AppendChunk(png, "IDAT", stream);
+    AppendChunk(png, "IEND", {});
+
+    std::ofstream fout(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    fout.write(reinterpret_cast<const char *>(png.data()), static_cast<std::streamsize>(png.size()));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Build random pixels.
+//! \param count The number of pixels.
+//! \param components The number of components of a pixel.
+//! \param engine A random engine.
+//! \return Pixels.
+std::vector<BYTE> BuildPixels(size_t count, UINT components, std::mt19937 &engine) {
+    std::uniform_int_distribution<UINT> distribution(0, 255);
+    std::vector<BYTE> pixels(count * components);
+    for (auto &component : pixels) {
+        component = static_cast<BYTE>(distribution(engine));
+    }
+    return pixels;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Build the expected contents of an 8 bit image pixel by pixel.
+//! \param pixels Source pixels.
+//! \param components The number of components of a source pixel.
+//! \param format The format of 8 bit images.
+//! \param premultiplied True if colors are multiplied by alpha.
+//! \return Expected contents.
+std::vector<BYTE> BuildExpectedContents(const std::vector<BYTE> &pixels, UINT components, DXGI_FORMAT format,
+                                        bool premultiplied) {
+    auto count = pixels.size() / components;
+    auto half = format == DXGI_FORMAT_R16G16B16A16_FLOAT;
+    std::vector<BYTE> contents(count * 4 * (half ? sizeof(UINT16) : 1));
+    for (size_t i = 0; i != count; ++i) {
+        BYTE rgba[4] = {pixels[i * components + 0], pixels[i * components + 1], pixels[i * components + 2],
+                        static_cast<BYTE>(components == 4 ? pixels[i * components + 3] : 255)};
+        if (premultiplied) {
+            for (auto c = 0; c != 3; ++c) {
+                rgba[c] = static_cast<BYTE>((rgba[c] * rgba[3] * 2 + 255) / 510);
+            }
+        }
+
+        if (format == DXGI_FORMAT_B8G8R8A8_UNORM || format == DXGI_FORMAT_B8G8R8A8_UNORM_SRGB) {
+            std::swap(rgba[0], rgba[2]);
+        }
+
+        if (half) {
+            ConvertSRGBToLinearHalf(rgba, reinterpret_cast<UINT16 *>(contents.data()) + i * 4, 1);
+        } else {
+            std::copy(rgba, rgba + 4, contents.data() + i * 4);
+        }
+    }
+    return contents;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Expect that asynchronous loads use the settings of a loader when they start, even if a loader is reconfigured or
+//! destroyed before they finish.
+//! \param root A directory for files.
+//! \param engine A random engine.
+void ExpectAsyncSettings(const std::filesystem::path &root, std::mt19937 &engine) {
+    constexpr UINT kSize = 16;
+
+    auto pixels = BuildPixels(kSize * kSize, 4, engine);
+    std::vector<std::filesystem::path> paths;
+    for (auto i = 0; i != 8; ++i) {
+        paths.push_back(root / ("async_" + std::to_string(i) + ".png"));
+        WritePNG(paths.back(), kSize, kSize, 4, pixels);
+    }
+
+    std::future<Image> future;
+    {
+        ImageLoader image_loader;
+        image_loader.SetLDRFormat(DXGI_FORMAT_B8G8R8A8_UNORM);
+        future = image_loader.LoadFileAsync(paths[0]);
+        image_loader.SetLDRFormat(DXGI_FORMAT_R8G8B8A8_UNORM);
+        image_loader.SetPremultipliedAlpha(true);
+    }
+
+    auto image = future.get();
+    Expect(image.format == DXGI_FORMAT_B8G8R8A8_UNORM);
+    Expect(image.contents == BuildExpectedContents(pixels, 4, DXGI_FORMAT_B8G8R8A8_UNORM, false));
+
+    // Images of concurrent loads are returned in the order of paths.
+    ImageLoader image_loader;
+    auto images = image_loader.LoadFiles(paths);
+    Expect(images.size() == paths.size());
+    for (auto &element : images) {
+        Expect(element.contents == BuildExpectedContents(pixels, 4, DXGI_FORMAT_R8G8B8A8_UNORM, false));
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Measure the best time of a function.
+//! \param function A function.
+//! \return The best time in nanoseconds.
+template<typename Function>
+double MeasureBest(Function function) {
+    constexpr auto kRunCount = 5;
+
+    auto best = std::numeric_limits<double>::max();
+    for (auto run = 0; run != kRunCount; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+
+    return best;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Compare loading a synthetic corpus of PNG files one by one with loading them concurrently.
+//! \param root A directory for files.
+//! \param engine A random engine.
+void RunBenchmark(const std::filesystem::path &root, std::mt19937 &engine) {
+    constexpr UINT kFileCount = 64;
+    constexpr UINT kSize = 512;
+
+    std::vector<std::filesystem::path> paths;
+    for (UINT i = 0; i != kFileCount; ++i) {
+        paths.push_back(root / ("corpus_" + std::to_string(i) + ".png"));
+        WritePNG(paths.back(), kSize, kSize, 4, BuildPixels(kSize * kSize, 4, engine));
+    }
+
+    ImageLoader image_loader;
+    image_loader.SetLDRFormat(DXGI_FORMAT_B8G8R8A8_UNORM_SRGB);
+    image_loader.SetPremultipliedAlpha(true);
+
+    auto report = [](const char *name, double time) {
+        std::printf("%-12s %8.3f ms %8.3f ms/file\n", name, time / 1e6, time / 1e6 / kFileCount);
+    };
+
+    report("LoadFile", MeasureBest([&] {
+        for (auto &path : paths) {
+            image_loader.LoadFile(path);
+        }
+    }));
+    report("LoadFiles", MeasureBest([&] { image_loader.LoadFiles(paths); }));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char *argv[]) {
+    auto root = std::filesystem::temp_directory_path() / "directx12_image_loader_test";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root);
+
+    std::mt19937 engine(20240101);
+
+    // A benchmark isn't a part of the test, so it is only run on request.
+    if (argc > 1 && std::string_view(argv[1]) == "--benchmark") {
+        RunBenchmark(root, engine);
+        std::filesystem::remove_all(root);
+        return EXIT_SUCCESS;
+    }
+
+    // The size isn't a multiple of a conversion chunk, so the last chunk is partial.
+    constexpr UINT kWidth = 67;
+    constexpr UINT kHeight = 71;
+
+    constexpr DXGI_FORMAT kFormats[] = {DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,
+                                        DXGI_FORMAT_B8G8R8A8_UNORM, DXGI_FORMAT_B8G8R8A8_UNORM_SRGB,
+                                        DXGI_FORMAT_R16G16B16A16_FLOAT};
+
+    // 8 bit images are converted to the final layout while they are loaded.
+    for (auto components : {3u, 4u}) {
+        auto pixels = BuildPixels(kWidth * kHeight, components, engine);
+        auto path = root / (components == 4 ? "rgba.png" : "rgb.png");
+        WritePNG(path, kWidth, kHeight, components, pixels);
+
+        for (auto format : kFormats) {
+            for (auto premultiplied : {false, true}) {
+                ImageLoader image_loader;
+                image_loader.SetLDRFormat(format);
+                image_loader.SetPremultipliedAlpha(premultiplied);
+
+                auto image = image_loader.LoadFile(path);
+                auto component_size = format == DXGI_FORMAT_R16G16B16A16_FLOAT ? sizeof(UINT16) : 1;
+                Expect(image.width == kWidth && image.height == kHeight);
+                Expect(image.format == format);
+                Expect(image.subresources.size() == 1);
+                Expect(image.subresources[0].row_pitch == kWidth * 4 * component_size);
+                Expect(image.contents == BuildExpectedContents(pixels, components, format, premultiplied));
+            }
+        }
+    }
+
+    // Formats which aren't produced by the conversion are rejected.
+    {
+        ImageLoader image_loader;
+        ExpectThrow(image_loader.SetLDRFormat(DXGI_FORMAT_R8G8_UNORM));
+        ExpectThrow(image_loader.SetHDRFormat(DXGI_FORMAT_R8G8B8A8_UNORM));
+    }
+
+    ExpectAsyncSettings(root, engine);
+
+    std::filesystem::remove_all(root);
+
+    return GetExitCode();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,430 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "common/pipeline_cache.h"
+#include "common/pipeline_hash.h"
+#include "test.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct RootSignatureStorage {
+    D3D12_DESCRIPTOR_RANGE ranges[2];
+    D3D12_ROOT_PARAMETER parameters[3];
+    D3D12_STATIC_SAMPLER_DESC samplers[1];
+    D3D12_ROOT_SIGNATURE_DESC desc;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct GraphicsPipelineStorage {
+    BYTE shaders[5][8];
+    char semantic_names[2][16];
+    D3D12_INPUT_ELEMENT_DESC elements[2];
+    D3D12_SO_DECLARATION_ENTRY declarations[1];
+    UINT strides[1];
+    D3D12_GRAPHICS_PIPELINE_STATE_DESC desc;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Build a root signature which has a descriptor table, root constants, a root descriptor and a static sampler.
+//! Members are assigned one by one, so padding and inactive members of unions keep the fill byte.
+//! \param fill A byte which fills storage first.
+//! \return A root signature.
+std::unique_ptr<RootSignatureStorage> BuildRootSignature(BYTE fill) {
+    auto storage = std::make_unique<RootSignatureStorage>();
+    memset(storage.get(), fill, sizeof(RootSignatureStorage));
+
+    for (UINT i = 0; i != 2; ++i) {
+        auto &range = storage->ranges[i];
+        range.RangeType = i ? D3D12_DESCRIPTOR_RANGE_TYPE_UAV : D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+        range.NumDescriptors = 2;
+        range.BaseShaderRegister = 0;
+        range.RegisterSpace = 0;
+        range.OffsetInDescriptorsFromTableStart = i * 2;
+    }
+
+    auto &table = storage->parameters[0];
+    table.ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    table.DescriptorTable.NumDescriptorRanges = 2;
+    table.DescriptorTable.pDescriptorRanges = storage->ranges;
+    table.ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+    auto &constants = storage->parameters[1];
+    constants.ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+    constants.Constants.ShaderRegister = 0;
+    constants.Constants.RegisterSpace = 0;
+    constants.Constants.Num32BitValues = 16;
+    constants.ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+
+    auto &descriptor = storage->parameters[2];
+    descriptor.ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+    descriptor.Descriptor.ShaderRegister = 1;
+    descriptor.Descriptor.RegisterSpace = 0;
+    descriptor.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+    auto &sampler = storage->samplers[0];
+    sampler.Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+    sampler.AddressU = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+    sampler.AddressV = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+    sampler.AddressW = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+    sampler.MipLODBias = 0.0f;
+    sampler.MaxAnisotropy = 1;
+    sampler.ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+    sampler.BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
+    sampler.MinLOD = 0.0f;
+    sampler.MaxLOD = D3D12_FLOAT32_MAX;
+    sampler.ShaderRegister = 0;
+    sampler.RegisterSpace = 0;
+    sampler.ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+    auto &desc = storage->desc;
+    desc.NumParameters = 3;
+    desc.pParameters = storage->parameters;
+    desc.NumStaticSamplers = 1;
+    desc.pStaticSamplers = storage->samplers;
+    desc.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+
+    return storage;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Build a graphics pipeline state which has every shader, a stream output and an input layout.
+//! Members are assigned one by one, so padding keeps the fill byte.
+//! \param fill A byte which fills storage first.
+//! \return A graphics pipeline state.
+std::unique_ptr<GraphicsPipelineStorage> BuildGraphicsPipeline(BYTE fill) {
+    auto storage = std::make_unique<GraphicsPipelineStorage>();
+    memset(storage.get(), fill, sizeof(GraphicsPipelineStorage));
+
+    for (UINT i = 0; i != 5; ++i) {
+        for (UINT j = 0; j != 8; ++j) {
+            storage->shaders[i][j] = static_cast<BYTE>(i * 8 + j);
+        }
+    }
+
+    strcpy(storage->semantic_names[0], "POSITION");
+    strcpy(storage->semantic_names[1], "TEXCOORD");
+    for (UINT i = 0; i != 2; ++i) {
+        auto &element = storage->elements[i];
+        element.SemanticName = storage->semantic_names[i];
+        element.SemanticIndex = 0;
+        element.Format = i ? DXGI_FORMAT_R32G32_FLOAT : DXGI_FORMAT_R32G32B32_FLOAT;
+        element.InputSlot = 0;
+        element.AlignedByteOffset = i * 12;
+        element.InputSlotClass = D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA;
+        element.InstanceDataStepRate = 0;
+    }
+
+    auto &declaration = storage->declarations[0];
+    declaration.Stream = 0;
+    declaration.SemanticName = storage->semantic_names[0];
+    declaration.SemanticIndex = 0;
+    declaration.StartComponent = 0;
+    declaration.ComponentCount = 4;
+    declaration.OutputSlot = 0;
+    storage->strides[0] = 16;
+
+    auto &desc = storage->desc;
+    desc.pRootSignature = nullptr;
+    desc.VS = {storage->shaders[0], 8};
+    desc.PS = {storage->shaders[1], 8};
+    desc.DS = {storage->shaders[2], 8};
+    desc.HS = {storage->shaders[3], 8};
+    desc.GS = {storage->shaders[4], 8};
+
+    auto &stream_output = desc.StreamOutput;
+    stream_output.pSODeclaration = storage->declarations;
+    stream_output.NumEntries = 1;
+    stream_output.pBufferStrides = storage->strides;
+    stream_output.NumStrides = 1;
+    stream_output.RasterizedStream = 0;
+
+    auto &blend_state = desc.BlendState;
+    blend_state.AlphaToCoverageEnable = FALSE;
+    blend_state.IndependentBlendEnable = FALSE;
+    for (auto &render_target : blend_state.RenderTarget) {
+        render_target.BlendEnable = FALSE;
+        render_target.LogicOpEnable = FALSE;
+        render_target.SrcBlend = D3D12_BLEND_ONE;
+        render_target.DestBlend = D3D12_BLEND_ZERO;
+        render_target.BlendOp = D3D12_BLEND_OP_ADD;
+        render_target.SrcBlendAlpha = D3D12_BLEND_ONE;
+        render_target.DestBlendAlpha = D3D12_BLEND_ZERO;
+        render_target.BlendOpAlpha = D3D12_BLEND_OP_ADD;
+        render_target.LogicOp = D3D12_LOGIC_OP_NOOP;
+        render_target.RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+    }
+    desc.SampleMask = UINT_MAX;
+
+    auto &rasterizer_state = desc.RasterizerState;
+    rasterizer_state.FillMode = D3D12_FILL_MODE_SOLID;
+    rasterizer_state.CullMode = D3D12_CULL_MODE_BACK;
+    rasterizer_state.FrontCounterClockwise = FALSE;
+    rasterizer_state.DepthBias = 0;
+    rasterizer_state.DepthBiasClamp = 0.0f;
+    rasterizer_state.SlopeScaledDepthBias = 0.0f;
+    rasterizer_state.DepthClipEnable = TRUE;
+    rasterizer_state.MultisampleEnable = FALSE;
+    rasterizer_state.AntialiasedLineEnable = FALSE;
+    rasterizer_state.ForcedSampleCount = 0;
+    rasterizer_state.ConservativeRaster = D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF;
+
+    auto &depth_stencil_state = desc.DepthStencilState;
+    depth_stencil_state.DepthEnable = TRUE;
+    depth_stencil_state.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL;
+    depth_stencil_state.DepthFunc = D3D12_COMPARISON_FUNC_LESS;
+    depth_stencil_state.StencilEnable = FALSE;
+    depth_stencil_state.StencilReadMask = 0xFF;
+    depth_stencil_state.StencilWriteMask = 0xFF;
+    for (auto face : {&depth_stencil_state.FrontFace, &depth_stencil_state.BackFace}) {
+        face->StencilFailOp = D3D12_STENCIL_OP_KEEP;
+        face->StencilDepthFailOp = D3D12_STENCIL_OP_KEEP;
+        face->StencilPassOp = D3D12_STENCIL_OP_KEEP;
+        face->StencilFunc = D3D12_COMPARISON_FUNC_ALWAYS;
+    }
+
+    desc.InputLayout = {storage->elements, 2};
+    desc.IBStripCutValue = D3D12_INDEX_BUFFER_STRIP_CUT_VALUE_DISABLED;
+    desc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+    desc.NumRenderTargets = 1;
+    for (auto &format : desc.RTVFormats) {
+        format = DXGI_FORMAT_UNKNOWN;
+    }
+    desc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+    desc.DSVFormat = DXGI_FORMAT_D32_FLOAT;
+    desc.SampleDesc = {1, 0};
+    desc.NodeMask = 0;
+    desc.CachedPSO = {nullptr, 0};
+    desc.Flags = D3D12_PIPELINE_STATE_FLAG_NONE;
+
+    return storage;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Expect that every change of a hashed field changes a key, and keys of changes are distinct.
+//! \param build A function which builds storage.
+//! \param hash A function which hashes storage.
+//! \param changes Functions which change a field of storage.
+template<typename Build, typename Hash, typename Change>
+void ExpectDistinctKeys(Build build, Hash hash, const std::vector<Change> &changes) {
+    auto key = hash(*build());
+    std::set<UINT64> keys = {key};
+    for (auto &change : changes) {
+        auto storage = build();
+        change(*storage);
+        auto changed_key = hash(*storage);
+        Expect(changed_key != key);
+        keys.insert(changed_key);
+    }
+    Expect(keys.size() == changes.size() + 1);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void TestRootSignatureHash() {
+    auto hash = [](const RootSignatureStorage &storage) {
+        return HashRootSignatureDesc(storage.desc);
+    };
+
+    // Equal descriptions at different addresses, whose padding is different, have the same key.
+    auto key = hash(*BuildRootSignature(0x00));
+    Expect(hash(*BuildRootSignature(0x00)) == key);
+    Expect(hash(*BuildRootSignature(0xCD)) == key);
+    Expect(hash(*BuildRootSignature(0xFF)) == key);
+
+    using Change = std::function<void(RootSignatureStorage &)>;
+    std::vector<Change> changes = {
+            [](auto &s) { s.desc.NumParameters = 2; },
+            [](auto &s) { s.desc.NumStaticSamplers = 0; },
+            [](auto &s) { s.desc.Flags = D3D12_ROOT_SIGNATURE_FLAG_NONE; },
+            [](auto &s) { s.parameters[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL; },
+            [](auto &s) { s.parameters[0].DescriptorTable.NumDescriptorRanges = 1; },
+            [](auto &s) { s.ranges[1].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_CBV; },
+            [](auto &s) { s.ranges[1].NumDescriptors = 3; },
+            [](auto &s) { s.ranges[1].BaseShaderRegister = 1; },
+            [](auto &s) { s.ranges[1].RegisterSpace = 1; },
+            [](auto &s) { s.ranges[1].OffsetInDescriptorsFromTableStart = 3; },
+            [](auto &s) { s.parameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL; },
+            [](auto &s) { s.parameters[1].Constants.ShaderRegister = 2; },
+            [](auto &s) { s.parameters[1].Constants.RegisterSpace = 2; },
+            [](auto &s) { s.parameters[1].Constants.Num32BitValues = 8; },
+            [](auto &s) { s.parameters[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV; },
+            [](auto &s) { s.parameters[2].Descriptor.ShaderRegister = 3; },
+            [](auto &s) { s.parameters[2].Descriptor.RegisterSpace = 3; },
+            [](auto &s) { s.samplers[0].Filter = D3D12_FILTER_MIN_MAG_MIP_POINT; },
+            [](auto &s) { s.samplers[0].AddressU = D3D12_TEXTURE_ADDRESS_MODE_CLAMP; },
+            [](auto &s) { s.samplers[0].AddressV = D3D12_TEXTURE_ADDRESS_MODE_CLAMP; },
+            [](auto &s) { s.samplers[0].AddressW = D3D12_TEXTURE_ADDRESS_MODE_CLAMP; },
+            [](auto &s) { s.samplers[0].MipLODBias = 1.0f; },
+            [](auto &s) { s.samplers[0].MaxAnisotropy = 16; },
+            [](auto &s) { s.samplers[0].ComparisonFunc = D3D12_COMPARISON_FUNC_LESS; },
+            [](auto &s) { s.samplers[0].BorderColor = D3D12_STATIC_BORDER_COLOR_OPAQUE_WHITE; },
+            [](auto &s) { s.samplers[0].MinLOD = 1.0f; },
+            [](auto &s) { s.samplers[0].MaxLOD = 4.0f; },
+            [](auto &s) { s.samplers[0].ShaderRegister = 1; },
+            [](auto &s) { s.samplers[0].RegisterSpace = 1; },
+            [](auto &s) { s.samplers[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL; }};
+    ExpectDistinctKeys([] { return BuildRootSignature(0x00); }, hash, changes);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void TestGraphicsPipelineHash() {
+    constexpr UINT64 kRootSignatureKey = 0x0123456789ABCDEF;
+
+    auto hash = [](const GraphicsPipelineStorage &storage) {
+        return HashGraphicsPipelineDesc(storage.desc, kRootSignatureKey);
+    };
+
+    // Equal descriptions at different addresses, whose padding is different, have the same key.
+    auto key = hash(*BuildGraphicsPipeline(0x00));
+    Expect(hash(*BuildGraphicsPipeline(0x00)) == key);
+    Expect(hash(*BuildGraphicsPipeline(0xCD)) == key);
+    Expect(hash(*BuildGraphicsPipeline(0xFF)) == key);
+
+    // A root signature is hashed by its key, and a cached blob doesn't change a pipeline state.
+    {
+        auto storage = BuildGraphicsPipeline(0x00);
+        storage->desc.pRootSignature = reinterpret_cast<ID3D12RootSignature *>(storage.get());
+        storage->desc.CachedPSO = {storage->shaders[0], 8};
+        Expect(hash(*storage) == key);
+        Expect(HashGraphicsPipelineDesc(storage->desc, kRootSignatureKey + 1) != key);
+    }
+
+    using Change = std::function<void(GraphicsPipelineStorage &)>;
+    std::vector<Change> changes = {
+            [](auto &s) { s.shaders[0][7] ^= 1; },
+            [](auto &s) { s.shaders[1][7] ^= 1; },
+            [](auto &s) { s.shaders[2][7] ^= 1; },
+            [](auto &s) { s.shaders[3][7] ^= 1; },
+            [](auto &s) { s.shaders[4][7] ^= 1; },
+            [](auto &s) { s.desc.VS.BytecodeLength = 7; },
+            [](auto &s) { s.desc.GS = {}; },
+            [](auto &s) { s.desc.StreamOutput.NumEntries = 0; },
+            [](auto &s) { s.declarations[0].Stream = 1; },
+            [](auto &s) { s.declarations[0].SemanticName = s.semantic_names[1]; },
+            [](auto &s) { s.declarations[0].SemanticIndex = 1; },
+            [](auto &s) { s.declarations[0].StartComponent = 1; },
+            [](auto &s) { s.declarations[0].ComponentCount = 3; },
+            [](auto &s) { s.declarations[0].OutputSlot = 1; },
+            [](auto &s) { s.desc.StreamOutput.NumStrides = 0; },
+            [](auto &s) { s.strides[0] = 32; },
+            [](auto &s) { s.desc.StreamOutput.RasterizedStream = D3D12_SO_NO_RASTERIZED_STREAM; },
+            [](auto &s) { s.desc.BlendState.AlphaToCoverageEnable = TRUE; },
+            [](auto &s) { s.desc.BlendState.IndependentBlendEnable = TRUE; },
+            [](auto &s) { s.desc.BlendState.RenderTarget[0].BlendEnable = TRUE; },
+            [](auto &s) { s.desc.BlendState.RenderTarget[0].LogicOpEnable = TRUE; },
+            [](auto &s) { s.desc.BlendState.RenderTarget[0].SrcBlend = D3D12_BLEND_SRC_ALPHA; },
+            [](auto &s) { s.desc.BlendState.RenderTarget[0].DestBlend = D3D12_BLEND_INV_SRC_ALPHA; },
+            [](auto &s) { s.desc.BlendState.RenderTarget[0].BlendOp = D3D12_BLEND_OP_MAX; },
+            [](auto &s) { s.desc.BlendState.RenderTarget[0].SrcBlendAlpha = D3D12_BLEND_SRC_ALPHA; },
+            [](auto &s) { s.desc.BlendState.RenderTarget[0].DestBlendAlpha = D3D12_BLEND_INV_SRC_ALPHA; },
+            [](auto &s) { s.desc.BlendState.RenderTarget[0].BlendOpAlpha = D3D12_BLEND_OP_MAX; },
+            [](auto &s) { s.desc.BlendState.RenderTarget[0].LogicOp = D3D12_LOGIC_OP_CLEAR; },
+            [](auto &s) { s.desc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_RED; },
+            [](auto &s) { s.desc.BlendState.RenderTarget[7].BlendEnable = TRUE; },
+            [](auto &s) { s.desc.SampleMask = 1; },
+            [](auto &s) { s.desc.RasterizerState.FillMode = D3D12_FILL_MODE_WIREFRAME; },
+            [](auto &s) { s.desc.RasterizerState.CullMode = D3D12_CULL_MODE_NONE; },
+            [](auto &s) { s.desc.RasterizerState.FrontCounterClockwise = TRUE; },
+            [](auto &s) { s.desc.RasterizerState.DepthBias = 1; },
+            [](auto &s) { s.desc.RasterizerState.DepthBiasClamp = 1.0f; },
+            [](auto &s) { s.desc.RasterizerState.SlopeScaledDepthBias = 1.0f; },
+            [](auto &s) { s.desc.RasterizerState.DepthClipEnable = FALSE; },
+            [](auto &s) { s.desc.RasterizerState.MultisampleEnable = TRUE; },
+            [](auto &s) { s.desc.RasterizerState.AntialiasedLineEnable = TRUE; },
+            [](auto &s) { s.desc.RasterizerState.ForcedSampleCount = 4; },
+            [](auto &s) { s.desc.RasterizerState.ConservativeRaster = D3D12_CONSERVATIVE_RASTERIZATION_MODE_ON; },
+            [](auto &s) { s.desc.DepthStencilState.DepthEnable = FALSE; },
+            [](auto &s) { s.desc.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO; },
+            [](auto &s) { s.desc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_GREATER; },
+            [](auto &s) { s.desc.DepthStencilState.StencilEnable = TRUE; },
+            [](auto &s) { s.desc.DepthStencilState.StencilReadMask = 0x0F; },
+            [](auto &s) { s.desc.DepthStencilState.StencilWriteMask = 0x0F; },
+            [](auto &s) { s.desc.DepthStencilState.FrontFace.StencilFailOp = D3D12_STENCIL_OP_ZERO; },
+            [](auto &s) { s.desc.DepthStencilState.FrontFace.StencilDepthFailOp = D3D12_STENCIL_OP_ZERO; },
+            [](auto &s) { s.desc.DepthStencilState.FrontFace.StencilPassOp = D3D12_STENCIL_OP_ZERO; },
+            [](auto &s) { s.desc.DepthStencilState.FrontFace.StencilFunc = D3D12_COMPARISON_FUNC_NEVER; },
+            [](auto &s) { s.desc.DepthStencilState.BackFace.StencilFunc = D3D12_COMPARISON_FUNC_NEVER; },
+            [](auto &s) { s.desc.InputLayout.NumElements = 1; },
+            [](auto &s) { s.semantic_names[1][0] = 'X'; },
+            [](auto &s) { s.elements[1].SemanticIndex = 1; },
+            [](auto &s) { s.elements[1].Format = DXGI_FORMAT_R16G16_FLOAT; },
+            [](auto &s) { s.elements[1].InputSlot = 1; },
+            [](auto &s) { s.elements[1].AlignedByteOffset = 16; },
+            [](auto &s) { s.elements[1].InputSlotClass = D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA; },
+            [](auto &s) { s.elements[1].InstanceDataStepRate = 1; },
+            [](auto &s) { s.desc.IBStripCutValue = D3D12_INDEX_BUFFER_STRIP_CUT_VALUE_0xFFFF; },
+            [](auto &s) { s.desc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_LINE; },
+            [](auto &s) { s.desc.NumRenderTargets = 2; },
+            [](auto &s) { s.desc.RTVFormats[0] = DXGI_FORMAT_R16G16B16A16_FLOAT; },
+            [](auto &s) { s.desc.RTVFormats[7] = DXGI_FORMAT_R8G8B8A8_UNORM; },
+            [](auto &s) { s.desc.DSVFormat = DXGI_FORMAT_D24_UNORM_S8_UINT; },
+            [](auto &s) { s.desc.SampleDesc.Count = 4; },
+            [](auto &s) { s.desc.SampleDesc.Quality = 1; },
+            [](auto &s) { s.desc.NodeMask = 1; },
+            [](auto &s) { s.desc.Flags = D3D12_PIPELINE_STATE_FLAG_TOOL_DEBUG; }};
+    ExpectDistinctKeys([] { return BuildGraphicsPipeline(0x00); }, hash, changes);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void TestRootSignatureFile() {
+    auto directory = std::filesystem::temp_directory_path() / "directx12_pipeline_hash_test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    auto key = HashRootSignatureDesc(BuildRootSignature(0x00)->desc);
+    auto path = directory / "root_signature.bin";
+    std::vector<BYTE> data = {0x44, 0x58, 0x42, 0x43, 0x01, 0x02, 0x03, 0x04, 0x05};
+
+    // A file is read back as it was written, and only for its key.
+    WriteRootSignatureFile(path, key, data);
+    Expect(ReadRootSignatureFile(path, key) == data);
+    Expect(ReadRootSignatureFile(path, key + 1).empty());
+    Expect(ReadRootSignatureFile(directory / "missing.bin", key).empty());
+
+    // An overwritten file replaces the previous one.
+    data.push_back(0x06);
+    WriteRootSignatureFile(path, key, data);
+    Expect(ReadRootSignatureFile(path, key) == data);
+
+    // A truncated file and a file of another version are ignored.
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    Expect(ReadRootSignatureFile(path, key).empty());
+
+    RootSignatureCacheHeader header = {kRootSignatureCacheMagic, kPipelineCacheVersion + 1, key, data.size()};
+    {
+        std::ofstream fout(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        fout.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        fout.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+    Expect(ReadRootSignatureFile(path, key).empty());
+
+    std::filesystem::remove_all(directory);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int main() {
+    TestRootSignatureHash();
+    TestGraphicsPipelineHash();
+    TestRootSignatureFile();
+
+    return GetExitCode();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,283 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "common/pixel_conversion.h"
+#include "test.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Pixel counts which cover an empty input, every tail length of the widest kernel and long inputs.
+constexpr size_t kCounts[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 64, 65, 255, 256, 257, 1023,
+                              4099};
+
+//! Paths which are compared against the scalar path.
+constexpr PixelConversionPath kPaths[] = {PixelConversionPath::kScalar, PixelConversionPath::kSSE4,
+                                          PixelConversionPath::kAVX2, PixelConversionPath::kNEON};
+
+//! Names of paths.
+constexpr const char *kPathNames[] = {"scalar", "sse4", "avx2", "neon"};
+
+//! The number of pixels of a benchmark, which is a 2048x2048 image.
+constexpr size_t kBenchmarkCount = 2048 * 2048;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Build random bytes.
+//! \param size The number of bytes.
+//! \param engine A random engine.
+//! \return Bytes.
+std::vector<BYTE> BuildBytes(size_t size, std::mt19937 &engine) {
+    std::uniform_int_distribution<UINT> distribution(0, 255);
+    std::vector<BYTE> bytes(size);
+    for (auto &byte : bytes) {
+        byte = static_cast<BYTE>(distribution(engine));
+    }
+    return bytes;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Build floats which exercise rounding. Special values, subnormals and halfway cases of half floats come first,
+//! and the rest are random bit patterns.
+//! \param size The number of floats.
+//! \param engine A random engine.
+//! \return Floats.
+std::vector<float> BuildFloats(size_t size, std::mt19937 &engine) {
+    const UINT32 special_bits[] = {
+            0x00000000, 0x80000000, 0x7F800000, 0xFF800000, 0x7FC00000, 0x7F800001, 0xFFFFFFFF, 0x00000001,
+            0x33000000, 0x33000001, 0x387FE000, 0x38800000, 0x3F801000, 0x3F803000, 0x3F801001, 0x477FE000,
+            0x477FEFFF, 0x477FF000, 0x3F810000, 0x3F808000, 0x3F808001, 0x3F818000, 0x47800000, 0xC7800000};
+
+    std::uniform_int_distribution<UINT32> distribution;
+    std::vector<float> floats(size);
+    for (size_t i = 0; i != size; ++i) {
+        auto bits = i < std::size(special_bits) ? special_bits[i] : distribution(engine);
+        memcpy(&floats[i], &bits, sizeof(bits));
+    }
+    return floats;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Expect that a conversion of many pixels is the same as conversions of each pixel. A conversion of a pixel
+//! always runs the scalar path, so it compares the vectorized path and its tail against the scalar path.
+//! \param function A conversion.
+//! \param src Source elements.
+//! \param src_stride The number of source elements of a pixel.
+//! \param dst_stride The number of destination elements of a pixel.
+//! \param count The number of pixels.
+template<typename Source, typename Destination, typename Function>
+void ExpectMatchScalar(Function function, const std::vector<Source> &src, size_t src_stride, size_t dst_stride,
+                       size_t count) {
+    std::vector<Destination> vectorized(count * dst_stride + 1, 0);
+    std::vector<Destination> scalar(count * dst_stride + 1, 0);
+
+    function(src.data(), vectorized.data(), count);
+    for (size_t i = 0; i != count; ++i) {
+        function(src.data() + i * src_stride, scalar.data() + i * dst_stride, 1);
+    }
+
+    // The extra element catches a write past the end.
+    Expect(vectorized == scalar);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Expect that an in place conversion is the same as an out of place conversion.
+//! \param function A conversion.
+//! \param src Source pixels.
+//! \param count The number of pixels.
+template<typename Function>
+void ExpectMatchInPlace(Function function, const std::vector<BYTE> &src, size_t count) {
+    std::vector<BYTE> out_of_place(count * 4);
+    std::vector<BYTE> in_place(src.begin(), src.begin() + static_cast<ptrdiff_t>(count * 4));
+
+    function(src.data(), out_of_place.data(), count);
+    function(in_place.data(), in_place.data(), count);
+    Expect(in_place == out_of_place);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Convert a half float to a float.
+//! \param half A half float.
+//! \return A float.
+float ConvertHalfToFloat(UINT16 half) {
+    auto exponent = (half >> 10) & 0x1F;
+    auto mantissa = half & 0x3FF;
+    auto magnitude = exponent == 0 ? std::ldexp(static_cast<float>(mantissa), -24) :
+                     exponent == 31 ? (mantissa ? std::numeric_limits<float>::quiet_NaN() :
+                                                  std::numeric_limits<float>::infinity()) :
+                     std::ldexp(static_cast<float>(mantissa | 0x400), exponent - 25);
+    return half & 0x8000 ? -magnitude : magnitude;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Expect that a float is converted to the nearest half float, and a tie is rounded to even.
+//! \param floats Floats.
+void ExpectRoundToNearestEven(const std::vector<float> &floats) {
+    std::vector<UINT16> halves(floats.size());
+    ConvertFloatToHalf(floats.data(), halves.data(), floats.size());
+
+    for (size_t i = 0; i != floats.size(); ++i) {
+        auto value = floats[i];
+        auto half = halves[i];
+        if (std::isnan(value)) {
+            Expect((half & 0x7C00) == 0x7C00 && (half & 0x3FF));
+            continue;
+        }
+
+        if (std::isinf(value)) {
+            Expect(half == (value > 0.0f ? 0x7C00 : 0xFC00));
+            continue;
+        }
+
+        // Neighbors of a half float must not be closer, and a tie must keep an even mantissa.
+        auto error = std::abs(static_cast<double>(ConvertHalfToFloat(half)) - value);
+        for (auto neighbor : {static_cast<UINT16>(half - 1), static_cast<UINT16>(half + 1)}) {
+            if ((neighbor & 0x7FFF) > 0x7C00 || ((neighbor ^ half) & 0x8000)) {
+                continue;
+            }
+
+            auto neighbor_error = std::abs(static_cast<double>(ConvertHalfToFloat(neighbor)) - value);
+            Expect(neighbor_error > error || (neighbor_error == error && !(half & 1)) || std::isinf(error));
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Measure the throughput of a conversion over a few runs.
+//! \param name The name of a conversion.
+//! \param bytes The number of bytes which a conversion reads and writes.
+//! \param function A conversion.
+template<typename Function>
+void MeasureThroughput(const char *name, size_t bytes, Function function) {
+    constexpr auto kRunCount = 10;
+
+    auto best = std::numeric_limits<double>::max();
+    for (auto run = 0; run != kRunCount; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+
+    std::printf("  %-24s %8.3f ms %8.2f GB/s\n", name, best * 1e3, static_cast<double>(bytes) / best / 1e9);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Measure the throughput of every conversion of a 2048x2048 image on the current path.
+//! \param engine A random engine.
+void RunBenchmark(std::mt19937 &engine) {
+    auto count = kBenchmarkCount;
+    auto bytes = BuildBytes(count * 4, engine);
+    auto floats = BuildFloats(count * 4, engine);
+    std::vector<BYTE> rgba(count * 4);
+    std::vector<UINT16> halves(count * 4);
+    std::vector<UINT32> packed(count);
+
+    MeasureThroughput("ConvertRGBToRGBA", count * 7, [&] { ConvertRGBToRGBA(bytes.data(), rgba.data(), count); });
+    MeasureThroughput("SwizzleRedBlue", count * 8, [&] { SwizzleRedBlue(bytes.data(), rgba.data(), count); });
+    MeasureThroughput("PremultiplyAlpha", count * 8, [&] { PremultiplyAlpha(bytes.data(), rgba.data(), count); });
+    MeasureThroughput("ConvertUNormToHalf", count * 12, [&] {
+        ConvertUNormToHalf(bytes.data(), halves.data(), count * 4);
+    });
+    MeasureThroughput("ConvertSRGBToLinearHalf", count * 12, [&] {
+        ConvertSRGBToLinearHalf(bytes.data(), halves.data(), count);
+    });
+    MeasureThroughput("ConvertFloatToHalf", count * 24, [&] {
+        ConvertFloatToHalf(floats.data(), halves.data(), count * 4);
+    });
+    MeasureThroughput("ConvertFloatToR11G11B10", count * 20, [&] {
+        ConvertFloatToR11G11B10(floats.data(), packed.data(), count);
+    });
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char *argv[]) {
+    std::mt19937 engine(20240101);
+
+    // A benchmark isn't a part of the test, so it is only run on request.
+    auto benchmark = argc > 1 && std::string_view(argv[1]) == "--benchmark";
+    auto supported = GetPixelConversionPath();
+
+    // Every path which a CPU supports is compared against conversions of each pixel, which run the scalar path.
+    for (auto requested : kPaths) {
+        auto path = SetPixelConversionPath(requested);
+        if (path != requested) {
+            continue;
+        }
+
+        if (benchmark) {
+            std::printf("%s\n", kPathNames[static_cast<size_t>(path)]);
+            RunBenchmark(engine);
+            continue;
+        }
+
+        for (auto count : kCounts) {
+            auto bytes = BuildBytes(count * 4 + 16, engine);
+            auto floats = BuildFloats(count * 4 + 16, engine);
+
+            ExpectMatchScalar<BYTE, BYTE>(ConvertRGBToRGBA, bytes, 3, 4, count);
+            ExpectMatchScalar<BYTE, BYTE>(SwizzleRedBlue, bytes, 4, 4, count);
+            ExpectMatchScalar<BYTE, BYTE>(PremultiplyAlpha, bytes, 4, 4, count);
+            ExpectMatchScalar<BYTE, UINT16>(ConvertUNormToHalf, bytes, 1, 1, count);
+            ExpectMatchScalar<BYTE, UINT16>(ConvertSRGBToLinearHalf, bytes, 4, 4, count);
+            ExpectMatchScalar<float, UINT16>(
+                    static_cast<void (*)(const float *, UINT16 *, size_t)>(ConvertFloatToHalf), floats, 1, 1, count);
+            ExpectMatchScalar<float, UINT32>(ConvertFloatToR11G11B10, floats, 4, 1, count);
+
+            ExpectMatchInPlace(SwizzleRedBlue, bytes, count);
+            ExpectMatchInPlace(PremultiplyAlpha, bytes, count);
+        }
+
+        // Premultiplication is exactly round(color * alpha / 255) for every pair.
+        std::vector<BYTE> pairs(256 * 256 * 4);
+        for (UINT i = 0; i != 256 * 256; ++i) {
+            pairs[i * 4 + 0] = pairs[i * 4 + 1] = pairs[i * 4 + 2] = static_cast<BYTE>(i & 0xFF);
+            pairs[i * 4 + 3] = static_cast<BYTE>(i >> 8);
+        }
+        std::vector<BYTE> premultiplied(pairs.size());
+        PremultiplyAlpha(pairs.data(), premultiplied.data(), 256 * 256);
+        for (UINT i = 0; i != 256 * 256; ++i) {
+            auto expected = ((i & 0xFF) * (i >> 8) * 2 + 255) / 510;
+            Expect(premultiplied[i * 4] == expected && premultiplied[i * 4 + 3] == (i >> 8));
+        }
+
+        ExpectRoundToNearestEven(BuildFloats(1 << 16, engine));
+    }
+
+    SetPixelConversionPath(supported);
+    if (benchmark) {
+        return EXIT_SUCCESS;
+    }
+
+    // 1 + 2^-7 + 2^-12 is above the halfway of 11 bit floats, so it rounds up once instead of to 1 + 2^-7 and to 1.
+    const float values[] = {1.0f + 0x1p-7f + 0x1p-12f, 1.0f + 0x1p-7f, 1.0f + 0x1p-6f + 0x1p-12f, 0.0f};
+    UINT32 packed;
+    ConvertFloatToR11G11B10(values, &packed, 1);
+    Expect((packed & 0x7FF) == 0x3C1);
+    Expect(((packed >> 11) & 0x7FF) == 0x3C0);
+    Expect((packed >> 22) == 0x1E1);
+
+    return GetExitCode();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,242 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "common/profiler.h"
+#include "test.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! The number of zones of a benchmark.
+constexpr UINT kBenchmarkCount = 1 << 20;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Write zones which have no children. A zone is entered at its index and left a tick later.
+//! \param buffer A buffer.
+//! \param first The index of the first zone.
+//! \param count The number of zones.
+void WriteZones(ProfileBuffer *buffer, UINT64 first, UINT64 count) {
+    for (auto i = first; i != first + count; ++i) {
+        buffer->Enter();
+        buffer->Leave("Zone", i, i + 1);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Expect that zones are written to a buffer.
+//! \param events Events.
+//! \param first The index of the first zone.
+//! \return True if events are consecutive zones from the first.
+bool AreZones(std::span<const ProfileEvent> events, UINT64 first) {
+    for (auto &event : events) {
+        if (event.begin != first || event.end != first + 1 || event.depth != 0) {
+            return false;
+        }
+        ++first;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Expect that a full buffer keeps the newest events, and that a read only returns events since the last read.
+void ExpectWraparound() {
+    constexpr UINT64 kOverflowCount = 100;
+
+    ProfileBuffer buffer(0, "Wraparound");
+    WriteZones(&buffer, 0, kProfileBufferCapacity + kOverflowCount);
+
+    // Events are appended after existing events.
+    std::vector<ProfileEvent> events(1, ProfileEvent{"Existing", 0, 0, 0, 0});
+    buffer.Read(&events);
+    Expect(events.size() == kProfileBufferCapacity + 1);
+    Expect(std::string_view(events[0].name) == "Existing");
+    Expect(AreZones(std::span(events).subspan(1), kOverflowCount));
+
+    events.clear();
+    WriteZones(&buffer, kProfileBufferCapacity + kOverflowCount, 10);
+    buffer.Read(&events);
+    Expect(events.size() == 10 && AreZones(events, kProfileBufferCapacity + kOverflowCount));
+
+    events.clear();
+    buffer.Read(&events);
+    Expect(events.empty());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Expect that a reader never returns a slot which is overwritten while it is read, even if a writer laps it.
+void ExpectConcurrentRead() {
+    constexpr UINT64 kZoneCount = kProfileBufferCapacity * 256;
+
+    ProfileBuffer buffer(0, "Concurrent");
+    std::atomic<bool> done = false;
+    std::thread writer([&buffer, &done]() {
+        WriteZones(&buffer, 0, kZoneCount);
+        done.store(true, std::memory_order_release);
+    });
+
+    // A slot which is torn has the beginning of a new zone and the end of an old zone, so events are consecutive
+    // within a read and increase across reads only if every torn slot is dropped.
+    std::vector<ProfileEvent> events;
+    UINT64 next = 0;
+    auto read = [&]() {
+        events.clear();
+        buffer.Read(&events);
+        if (!events.empty()) {
+            Expect(events.front().begin >= next && AreZones(events, events.front().begin));
+            next = events.back().end;
+        }
+    };
+
+    while (!done.load(std::memory_order_acquire)) {
+        read();
+    }
+    writer.join();
+
+    read();
+    Expect(next == kZoneCount);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Expect that a node matches.
+//! \param node A node.
+//! \param name The expected name.
+//! \param depth The expected depth.
+//! \param count The expected count.
+void ExpectNode(const ProfileNode &node, std::string_view name, UINT32 depth, UINT32 count) {
+    Expect(node.name == name && node.depth == depth && node.count == count);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Expect that zones which have the same path are merged, and that a zone whose parent isn't collected yet isn't
+//! attached to a sibling which has ended.
+void ExpectAggregate() {
+    auto profiler = Profiler::GetInstance();
+    auto buffer = Profiler::GetThreadBuffer();
+    Profiler::SetThreadName("Main");
+
+    // Children are written before their parents, like zones which are left.
+    buffer->Enter();
+    buffer->Enter();
+    buffer->Leave("Child", 110, 120);
+    buffer->Enter();
+    buffer->Leave("Child", 130, 140);
+    buffer->Enter();
+    buffer->Enter();
+    buffer->Leave("Grandchild", 152, 155);
+    buffer->Leave("Other", 150, 160);
+    buffer->Leave("Parent", 100, 200);
+    buffer->Enter();
+    buffer->Leave("Sibling", 300, 400);
+    profiler->EndFrame();
+
+    auto &frame = profiler->GetFrame();
+    Expect(frame.size() == 6);
+    if (frame.size() == 6) {
+        ExpectNode(frame[0], "Main", 0, 1);
+        ExpectNode(frame[1], "Parent", 1, 1);
+        ExpectNode(frame[2], "Child", 2, 2);
+        ExpectNode(frame[3], "Other", 2, 1);
+        ExpectNode(frame[4], "Grandchild", 3, 1);
+        ExpectNode(frame[5], "Sibling", 1, 1);
+        Expect(frame[0].time >= frame[1].time && frame[1].time >= frame[2].time && frame[2].time > 0);
+    }
+
+    // The parent of a child is still open when a frame ends, so the child is attached to the thread.
+    buffer->Enter();
+    buffer->Leave("Ended", 500, 510);
+    buffer->Enter();
+    buffer->Enter();
+    buffer->Leave("Orphan", 520, 530);
+    profiler->EndFrame();
+
+    Expect(frame.size() == 3);
+    if (frame.size() == 3) {
+        ExpectNode(frame[0], "Main", 0, 1);
+        ExpectNode(frame[1], "Ended", 1, 1);
+        ExpectNode(frame[2], "Orphan", 1, 1);
+    }
+
+    buffer->Leave("Open", 515, 540);
+    profiler->EndFrame();
+
+    Expect(frame.size() == 2);
+    if (frame.size() == 2) {
+        ExpectNode(frame[1], "Open", 1, 1);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Measure the best time of a function.
+//! \param function A function.
+//! \return The best time in nanoseconds.
+template<typename Function>
+double MeasureBest(Function function) {
+    constexpr auto kRunCount = 10;
+
+    auto best = std::numeric_limits<double>::max();
+    for (auto run = 0; run != kRunCount; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+
+    return best;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Measure the overhead of a zone, which should be well under 50 nanoseconds.
+void RunBenchmark() {
+    auto report = [](const char *name, double time) {
+        std::printf("%-12s %8.3f ms %6.3f ns/zone\n", name, time / 1e6, time / kBenchmarkCount);
+    };
+
+    std::atomic<UINT64> sink = 0;
+    report("Now", MeasureBest([&sink] {
+        for (UINT i = 0; i != kBenchmarkCount; ++i) {
+            sink.store(Profiler::Now(), std::memory_order_relaxed);
+        }
+    }));
+    report("ProfileScope", MeasureBest([] {
+        for (UINT i = 0; i != kBenchmarkCount; ++i) {
+            ProfileScope("Benchmark");
+        }
+    }));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char *argv[]) {
+    // A benchmark isn't a part of the test, so it is only run on request.
+    if (argc > 1 && std::string_view(argv[1]) == "--benchmark") {
+        RunBenchmark();
+        return EXIT_SUCCESS;
+    }
+
+    ExpectWraparound();
+    ExpectConcurrentRead();
+    ExpectAggregate();
+
+    return GetExitCode();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,84 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "common/shader_cache.h"
+#include "test.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! The key of a compiled shader.
+constexpr UINT64 kKey = 0x0123456789ABCDEF;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Retrieve the file of a key.
+//! \param root The directory of a cache.
+//! \param key A key of a compiled shader.
+//! \return A file path.
+std::filesystem::path GetCachePath(const std::filesystem::path &root, UINT64 key) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.dxil", static_cast<unsigned long long>(key));
+    return root / name;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Overwrite the size of code in the header of a file.
+//! \param path A file path.
+//! \param size The size of code.
+void WriteCodeSize(const std::filesystem::path &path, UINT64 size) {
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(offsetof(ShaderCacheHeader, size));
+    file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int main() {
+    auto root = std::filesystem::temp_directory_path() / "directx12_shader_cache_test";
+    std::filesystem::remove_all(root);
+
+    ShaderCache cache(root);
+    const std::vector<BYTE> code = {0x44, 0x58, 0x42, 0x43, 0x01, 0x02, 0x03};
+    const std::vector<std::filesystem::path> dependencies = {"shader.hlsl", "include/common.hlsli"};
+    auto path = GetCachePath(root, kKey);
+
+    // A stored shader is loaded with its dependencies.
+    Expect(!cache.Load(kKey));
+    cache.Store(kKey, code, dependencies);
+    auto shader = cache.Load(kKey);
+    Expect(shader && shader->code == code && shader->dependencies == dependencies);
+
+    // A size which doesn't match the file is a miss, and a huge size isn't allocated.
+    WriteCodeSize(path, UINT64_MAX - 8);
+    Expect(!cache.Load(kKey));
+    WriteCodeSize(path, code.size() - 1);
+    Expect(!cache.Load(kKey));
+    WriteCodeSize(path, code.size());
+    Expect(cache.Load(kKey).has_value());
+
+    // Trailing bytes and a truncated file are misses.
+    auto file_size = std::filesystem::file_size(path);
+    {
+        std::ofstream fout(path, std::ios::out | std::ios::binary | std::ios::app);
+        fout.put(0);
+    }
+    Expect(!cache.Load(kKey));
+    std::filesystem::resize_file(path, file_size - 1);
+    Expect(!cache.Load(kKey));
+
+    std::filesystem::remove_all(root);
+
+    return GetExitCode();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,60 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#ifndef TEST_H_
+#define TEST_H_
+
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Retrieve the number of failed expectations.
+//! \return The number of failed expectations.
+inline int &GetFailureCount() {
+    static int failure_count = 0;
+    return failure_count;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Report a failure if a condition is false. A test continues after a failure.
+//! \param condition A condition.
+#define Expect(condition) {                                                           \
+    if (!(condition)) {                                                               \
+        std::fprintf(stderr, "%s(%d): failed: %s\n", __FILE__, __LINE__, #condition); \
+        ++GetFailureCount();                                                          \
+    }                                                                                 \
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Report a failure if a statement doesn't throw an exception.
+//! \param statement A statement.
+#define ExpectThrow(statement) {                                                                    \
+    auto thrown = false;                                                                            \
+    try {                                                                                           \
+        statement;                                                                                  \
+    } catch (const std::exception &) {                                                              \
+        thrown = true;                                                                              \
+    }                                                                                               \
+    if (!thrown) {                                                                                  \
+        std::fprintf(stderr, "%s(%d): failed: %s doesn't throw\n", __FILE__, __LINE__, #statement); \
+        ++GetFailureCount();                                                                        \
+    }                                                                                               \
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Retrieve the exit code of a test.
+//! \return EXIT_SUCCESS if every expectation is satisfied, otherwise EXIT_FAILURE.
+inline int GetExitCode() {
+    return GetFailureCount() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
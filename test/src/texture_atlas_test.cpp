@@ -0,0 +1,277 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "common/texture_atlas.h"
+#include "test.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! The byte size of a texel.
+constexpr UINT kTexelSize = 4;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Build an image whose texels are given by a function.
+//! \param width The width of an image.
+//! \param height The height of an image.
+//! \param format The format of an image.
+//! \param texel A function which returns a texel at a coordinate.
+//! \return An image.
+template<typename Function>
+Image BuildImage(UINT width, UINT height, DXGI_FORMAT format, Function texel) {
+    Image image;
+    image.width = width;
+    image.height = height;
+    image.array_size = 1;
+    image.mip_levels = 1;
+    image.format = format;
+    image.contents.resize(static_cast<size_t>(width) * height * kTexelSize);
+    for (UINT y = 0; y != height; ++y) {
+        for (UINT x = 0; x != width; ++x) {
+            std::array<BYTE, 4> value = texel(x, y);
+            memcpy(image.contents.data() + (y * width + x) * kTexelSize, value.data(), kTexelSize);
+        }
+    }
+    image.subresources.push_back({image.contents.data(), width * kTexelSize, height});
+    return image;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Retrieve a texel of an image.
+//! \param image An image.
+//! \param mip_slice The mip slice.
+//! \param x The x coordinate of a texel.
+//! \param y The y coordinate of a texel.
+//! \return A texel.
+std::array<BYTE, 4> GetTexel(const Image &image, UINT16 mip_slice, UINT x, UINT y) {
+    auto &subresource = image.subresources[mip_slice];
+    std::array<BYTE, 4> texel = {};
+    memcpy(texel.data(), subresource.data + y * subresource.row_pitch + x * kTexelSize, kTexelSize);
+    return texel;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! The rectangle of a cell which has an image and its gutter at mip 0.
+struct CellRect {
+    UINT page;
+    UINT x;
+    UINT y;
+    UINT width;
+    UINT height;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Calculate the rectangle of a cell from a region. A cell is an image surrounded by a gutter of a texel of the
+//! smallest mip, and it is aligned to the texel of the smallest mip.
+//! \param region A region.
+//! \param image An image.
+//! \param page_size The width and the height of a page.
+//! \param mip_levels The number of mips of a page.
+//! \return A cell rectangle.
+CellRect CalculateCellRect(const AtlasRegion &region, const Image &image, UINT page_size, UINT16 mip_levels) {
+    auto alignment = 1u << (mip_levels - 1);
+    auto x = static_cast<UINT>(std::lround(region.offset_u * page_size)) - alignment;
+    auto y = static_cast<UINT>(std::lround(region.offset_v * page_size)) - alignment;
+    auto width = (static_cast<UINT>(image.width) + alignment * 2 + alignment - 1) / alignment * alignment;
+    auto height = (image.height + alignment * 2 + alignment - 1) / alignment * alignment;
+    return {region.page, x, y, width, height};
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Expect that regions map images to pages, texels are copied, and gutters extend edge texels.
+//! \param engine A random engine.
+void ExpectPacking(std::mt19937 &engine) {
+    constexpr UINT kPageSize = 256;
+    constexpr UINT16 kMipLevels = 4;
+
+    std::uniform_int_distribution<UINT> size(1, 70);
+    std::uniform_int_distribution<UINT> component(0, 255);
+    std::vector<Image> images;
+    for (auto i = 0; i != 24; ++i) {
+        auto seed = component(engine);
+        images.push_back(BuildImage(size(engine), size(engine), DXGI_FORMAT_R8G8B8A8_UNORM, [i, seed](UINT x, UINT y) {
+            return std::array<BYTE, 4>{static_cast<BYTE>(x), static_cast<BYTE>(y), static_cast<BYTE>(i),
+                                       static_cast<BYTE>(seed)};
+        }));
+    }
+
+    std::vector<const Image *> pointers;
+    for (auto &image : images) {
+        pointers.push_back(&image);
+    }
+
+    TextureAtlas atlas(pointers, kPageSize, kMipLevels);
+    auto &pages = atlas.GetPages();
+    auto &regions = atlas.GetRegions();
+    Expect(!pages.empty() && regions.size() == images.size());
+
+    for (auto &page : pages) {
+        Expect(page.width == kPageSize && page.height == kPageSize && page.mip_levels == kMipLevels);
+        Expect(page.format == DXGI_FORMAT_R8G8B8A8_UNORM && page.subresources.size() == kMipLevels);
+    }
+
+    std::vector<CellRect> cells;
+    for (UINT i = 0; i != images.size(); ++i) {
+        auto &image = images[i];
+        auto &region = regions[i];
+        Expect(region.page < pages.size());
+        Expect(region.scale_u * kPageSize == image.width && region.scale_v * kPageSize == image.height);
+
+        auto cell = CalculateCellRect(region, image, kPageSize, kMipLevels);
+        Expect(cell.x + cell.width <= kPageSize && cell.y + cell.height <= kPageSize);
+        Expect(cell.x % 8 == 0 && cell.y % 8 == 0);
+
+        // Cells of a page never overlap.
+        for (auto &other : cells) {
+            Expect(other.page != cell.page || other.x >= cell.x + cell.width || cell.x >= other.x + other.width ||
+                   other.y >= cell.y + cell.height || cell.y >= other.y + other.height);
+        }
+        cells.push_back(cell);
+
+        // A texel of a gutter is the nearest texel of an image.
+        auto &page = pages[region.page];
+        for (UINT y = 0; y != cell.height; ++y) {
+            for (UINT x = 0; x != cell.width; ++x) {
+                auto src_x = std::clamp<INT>(static_cast<INT>(x) - 8, 0, static_cast<INT>(image.width) - 1);
+                auto src_y = std::clamp<INT>(static_cast<INT>(y) - 8, 0, static_cast<INT>(image.height) - 1);
+                Expect(GetTexel(page, 0, cell.x + x, cell.y + y) == GetTexel(image, 0, src_x, src_y));
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Expect that images which don't fit to a page overflow to new pages.
+void ExpectPageOverflow() {
+    constexpr UINT kPageSize = 64;
+    constexpr UINT16 kMipLevels = 3;
+
+    // A cell of 40x40 is 48x48 with its gutter, so only one cell fits to a page.
+    std::vector<Image> images;
+    for (auto i = 0; i != 5; ++i) {
+        images.push_back(BuildImage(40, 40, DXGI_FORMAT_B8G8R8A8_UNORM, [i](UINT, UINT) {
+            return std::array<BYTE, 4>{static_cast<BYTE>(i), 0, 0, 255};
+        }));
+    }
+
+    std::vector<const Image *> pointers;
+    for (auto &image : images) {
+        pointers.push_back(&image);
+    }
+
+    TextureAtlas atlas(pointers, kPageSize, kMipLevels);
+    Expect(atlas.GetPages().size() == images.size());
+
+    std::vector<bool> used(images.size());
+    for (UINT i = 0; i != images.size(); ++i) {
+        auto &region = atlas.GetRegions()[i];
+        Expect(region.page < images.size() && !used[region.page]);
+        used[region.page] = true;
+
+        auto cell = CalculateCellRect(region, images[i], kPageSize, kMipLevels);
+        Expect(GetTexel(atlas.GetPages()[region.page], 0, cell.x + 8, cell.y + 8)[0] == i);
+    }
+
+    // An image which doesn't fit to an empty page is rejected.
+    auto large = BuildImage(57, 8, DXGI_FORMAT_B8G8R8A8_UNORM, [](UINT, UINT) { return std::array<BYTE, 4>{}; });
+    const Image *large_pointers[] = {&large};
+    ExpectThrow(TextureAtlas(large_pointers, kPageSize, kMipLevels));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Expect that every mip of a cell only has the color of its image, so neighbours and cleared texels never bleed.
+//! \param format The format of images.
+void ExpectMipGutters(DXGI_FORMAT format) {
+    constexpr UINT kPageSize = 128;
+    constexpr UINT16 kMipLevels = 5;
+
+    // Sizes which aren't multiples of the smallest mip leave a gutter which is wider than a texel.
+    const UINT sizes[][2] = {{17, 5}, {1, 1}, {30, 30}, {9, 40}, {50, 3}, {16, 16}, {7, 33}};
+    std::vector<Image> images;
+    for (UINT i = 0; i != std::size(sizes); ++i) {
+        auto color = std::array<BYTE, 4>{static_cast<BYTE>(30 * i + 10), static_cast<BYTE>(200 - 20 * i),
+                                         static_cast<BYTE>(i * 37), static_cast<BYTE>(255 - i)};
+        images.push_back(BuildImage(sizes[i][0], sizes[i][1], format, [color](UINT, UINT) { return color; }));
+    }
+
+    std::vector<const Image *> pointers;
+    for (auto &image : images) {
+        pointers.push_back(&image);
+    }
+
+    TextureAtlas atlas(pointers, kPageSize, kMipLevels);
+    for (UINT i = 0; i != images.size(); ++i) {
+        auto cell = CalculateCellRect(atlas.GetRegions()[i], images[i], kPageSize, kMipLevels);
+        auto color = GetTexel(images[i], 0, 0, 0);
+        auto &page = atlas.GetPages()[cell.page];
+
+        for (UINT16 mip = 0; mip != kMipLevels; ++mip) {
+            for (auto y = cell.y >> mip; y != (cell.y + cell.height) >> mip; ++y) {
+                for (auto x = cell.x >> mip; x != (cell.x + cell.width) >> mip; ++x) {
+                    Expect(GetTexel(page, mip, x, y) == color);
+                }
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Expect that invalid arguments are rejected, and that an atlas of no images has no pages.
+void ExpectInvalidArguments() {
+    auto texel = [](UINT, UINT) { return std::array<BYTE, 4>{}; };
+    auto rgba = BuildImage(4, 4, DXGI_FORMAT_R8G8B8A8_UNORM, texel);
+    auto bgra = BuildImage(4, 4, DXGI_FORMAT_B8G8R8A8_UNORM, texel);
+    auto half = BuildImage(4, 4, DXGI_FORMAT_R16G16_FLOAT, texel);
+    auto empty = BuildImage(0, 4, DXGI_FORMAT_R8G8B8A8_UNORM, texel);
+
+    TextureAtlas none({}, 64, 3);
+    Expect(none.GetPages().empty() && none.GetRegions().empty());
+
+    const Image *images[] = {&rgba};
+    ExpectThrow(TextureAtlas(images, 64, 0));
+    ExpectThrow(TextureAtlas(images, 64, 8));
+    ExpectThrow(TextureAtlas(images, 0, 1));
+    ExpectThrow(TextureAtlas(images, 60, 4));
+    TextureAtlas(images, 64, 3);
+
+    const Image *mixed[] = {&rgba, &bgra};
+    ExpectThrow(TextureAtlas(mixed, 64, 3));
+
+    const Image *unsupported[] = {&half};
+    ExpectThrow(TextureAtlas(unsupported, 64, 3));
+
+    const Image *zero[] = {&empty};
+    ExpectThrow(TextureAtlas(zero, 64, 3));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int main() {
+    std::mt19937 engine(20240101);
+
+    ExpectPacking(engine);
+    ExpectPageOverflow();
+    ExpectMipGutters(DXGI_FORMAT_R8G8B8A8_UNORM);
+    ExpectMipGutters(DXGI_FORMAT_B8G8R8A8_UNORM_SRGB);
+    ExpectInvalidArguments();
+
+    return GetExitCode();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
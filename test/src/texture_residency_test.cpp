@@ -0,0 +1,175 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+#include "common/texture_residency.h"
+#include "test.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! The byte size of mips which fit to the tail of a 256x256 texture, from mip 2 to mip 8.
+constexpr UINT64 kTailSize = 21844;
+
+//! The byte size of mip 1 of a 256x256 texture.
+constexpr UINT64 kMip1Size = 65536;
+
+//! The byte size of mip 0 of a 256x256 texture.
+constexpr UINT64 kMip0Size = 262144;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Build an image of a 256x256 RGBA8 texture with all mips. Residency only needs the layout, so it has no contents.
+//! \return An image.
+Image BuildImage() {
+    Image image;
+    image.width = 256;
+    image.height = 256;
+    image.array_size = 1;
+    image.mip_levels = 9;
+    image.format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    for (UINT mip = 0; mip != image.mip_levels; ++mip) {
+        image.subresources.push_back({nullptr, static_cast<UINT64>(256 >> mip) * 4, 256u >> mip});
+    }
+    return image;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Expect that requests match.
+//! \param requests Requests of a frame.
+//! \param expected Expected requests.
+void ExpectRequests(const std::vector<StreamRequest> &requests, const std::vector<StreamRequest> &expected) {
+    Expect(requests.size() == expected.size());
+    for (size_t i = 0; i != std::min(requests.size(), expected.size()); ++i) {
+        Expect(requests[i].texture == expected[i].texture && requests[i].mip_slice == expected[i].mip_slice);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Expect that the distance selects the mip, and that invalid distances select full detail.
+void ExpectMipSelection() {
+    constexpr auto kNaN = std::numeric_limits<float>::quiet_NaN();
+    constexpr auto kInfinity = std::numeric_limits<float>::infinity();
+
+    TextureResidency residency({});
+    auto texture = residency.AddTexture(BuildImage());
+    Expect(residency.GetResidentMip(texture) == 2);
+    Expect(residency.GetResidentSize() == kTailSize);
+
+    const float distances[] = {0.0f, 0.5f, 1.0f, 1.9f, 2.0f, 3.9f, 4.0f, 1000.0f, kInfinity, -5.0f, -kInfinity, kNaN};
+    const UINT16 mips[] = {0, 0, 0, 0, 1, 1, 2, 2, 2, 0, 0, 0};
+    for (size_t i = 0; i != std::size(distances); ++i) {
+        residency.SetDistance(texture, distances[i]);
+        Expect(residency.GetRequiredMip(texture) == mips[i]);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Expect that mips are streamed from the coarse to the fine within the upload budget.
+void ExpectUploadBudget() {
+    ResidencyBudget budget;
+    budget.upload_size = kMip1Size;
+
+    TextureResidency residency(budget);
+    auto texture = residency.AddTexture(BuildImage());
+
+    // Mip 0 doesn't fit to the rest of the budget, so it waits for the next frame.
+    residency.SetDistance(texture, 0.0f);
+    ExpectRequests(residency.Update(), {{texture, 1}});
+    Expect(residency.GetResidentMip(texture) == 1);
+
+    // A mip which is larger than the upload budget is streamed alone.
+    residency.SetDistance(texture, 0.0f);
+    ExpectRequests(residency.Update(), {{texture, 0}});
+    Expect(residency.GetResidentMip(texture) == 0);
+    Expect(residency.GetResidentSize() == kTailSize + kMip1Size + kMip0Size);
+
+    // Nothing is streamed once the texture is fully resident.
+    residency.SetDistance(texture, 0.0f);
+    ExpectRequests(residency.Update(), {});
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Expect that the texture which lacks the most mips is streamed first, and that the closer texture wins on a tie.
+void ExpectPriority() {
+    TextureResidency residency({});
+    auto distant = residency.AddTexture(BuildImage());
+    auto close = residency.AddTexture(BuildImage());
+    auto unused = residency.AddTexture(BuildImage());
+
+    residency.SetDistance(distant, 2.0f);
+    residency.SetDistance(close, 0.0f);
+    ExpectRequests(residency.Update(), {{close, 1}, {close, 0}, {distant, 1}});
+
+    // Textures which aren't used in this frame aren't streamed.
+    Expect(residency.GetResidentMip(unused) == 2);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Expect that surplus mips are evicted first, then the least recently used textures, and that mips which are
+//! required in this frame are never evicted.
+void ExpectEvictionOrder() {
+    ResidencyBudget budget;
+    budget.memory_size = kTailSize * 3 + kMip1Size * 2;
+
+    TextureResidency residency(budget);
+    UINT textures[3];
+    for (auto &texture : textures) {
+        texture = residency.AddTexture(BuildImage());
+    }
+
+    // Frame 0: two textures fill the memory budget.
+    residency.SetDistance(textures[0], 2.0f);
+    residency.SetDistance(textures[1], 2.0f);
+    ExpectRequests(residency.Update(), {{textures[0], 1}, {textures[1], 1}});
+    Expect(residency.GetResidentSize() == budget.memory_size);
+
+    // Frame 1: the least recently used texture is evicted.
+    residency.SetDistance(textures[1], 2.0f);
+    residency.SetDistance(textures[2], 2.0f);
+    ExpectRequests(residency.Update(), {{textures[2], 1}});
+    Expect(residency.GetResidentMip(textures[0]) == 2);
+    Expect(residency.GetResidentMip(textures[1]) == 1);
+    Expect(residency.GetResidentSize() == budget.memory_size);
+
+    // Frame 2: the texture which has moved away is evicted before the least recently used texture.
+    residency.SetDistance(textures[0], 2.0f);
+    residency.SetDistance(textures[1], 1000.0f);
+    ExpectRequests(residency.Update(), {{textures[0], 1}});
+    Expect(residency.GetResidentMip(textures[1]) == 2);
+    Expect(residency.GetResidentMip(textures[2]) == 1);
+    Expect(residency.GetResidentSize() == budget.memory_size);
+
+    // Frame 3: every resident mip is required, so nothing is evicted and nothing is streamed.
+    for (auto texture : textures) {
+        residency.SetDistance(texture, 0.0f);
+    }
+    ExpectRequests(residency.Update(), {});
+    Expect(residency.GetResidentMip(textures[0]) == 1);
+    Expect(residency.GetResidentMip(textures[1]) == 2);
+    Expect(residency.GetResidentMip(textures[2]) == 1);
+    Expect(residency.GetResidentSize() == budget.memory_size);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int main() {
+    ExpectMipSelection();
+    ExpectUploadBudget();
+    ExpectPriority();
+    ExpectEvictionOrder();
+
+    return GetExitCode();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
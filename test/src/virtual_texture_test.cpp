@@ -0,0 +1,278 @@
+//
+// This file is part of the "DirectX12" project
+// See "LICENSE" for license information.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "common/virtual_texture.h"
+#include "test.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! The description of a 64x64 RGBA8 texture. Mips from 3 are smaller than a tile.
+constexpr VirtualTextureDesc kDesc = {64, 64, 7, DXGI_FORMAT_R8G8B8A8_UNORM, 4};
+
+//! The width and the height of a tile.
+constexpr UINT kTileSize = 16;
+
+//! The number of slots. The coarsest mip has a single tile, which is pinned.
+constexpr UINT kSlotCount = 4;
+
+//! The number of updates to wait for loads.
+constexpr UINT kMaxUpdateCount = 1000;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Build the value of texels of a tile.
+//! \param tile A tile id.
+//! \return The value of texels.
+BYTE BuildTexel(const TileId &tile) {
+    return static_cast<BYTE>(0x80 | (tile.mip_slice << 4) | (tile.y << 2) | tile.x);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! A source of tiles which counts reads. Only texels inside of a texture are written.
+class TileSource final {
+public:
+    //! Read a tile.
+    //! \param tile A tile id.
+    //! \param data The destination.
+    //! \param row_pitch The byte size of a row of a tile.
+    void Read(const TileId &tile, std::span<BYTE> data, UINT64 row_pitch) {
+        {
+            std::lock_guard lock(_mutex);
+            auto count = ++_read_counts[PackTileId(tile)];
+            if (count <= _failure_counts[PackTileId(tile)]) {
+                throw std::runtime_error("Fail to read a tile.");
+            }
+        }
+
+        auto [width, height] = GetExtent(tile);
+        for (UINT y = 0; y != height; ++y) {
+            std::fill_n(data.begin() + static_cast<ptrdiff_t>(y * row_pitch), width * kDesc.element_size,
+                        BuildTexel(tile));
+        }
+    }
+
+    //! Make the first reads of a tile fail.
+    //! \param tile A tile id.
+    //! \param count The number of reads which fail.
+    void SetFailureCount(const TileId &tile, UINT count) {
+        std::lock_guard lock(_mutex);
+        _failure_counts[PackTileId(tile)] = count;
+    }
+
+    //! Retrieve the number of reads of a tile.
+    //! \param tile A tile id.
+    //! \return The number of reads.
+    UINT GetReadCount(const TileId &tile) {
+        std::lock_guard lock(_mutex);
+        return _read_counts[PackTileId(tile)];
+    }
+
+    //! Retrieve the number of reads of all tiles.
+    //! \return The number of reads.
+    UINT GetTotalReadCount() {
+        std::lock_guard lock(_mutex);
+        UINT total = 0;
+        for (auto &[tile, count] : _read_counts) {
+            total += count;
+        }
+        return total;
+    }
+
+    //! Retrieve the texels of a tile which are inside of a texture.
+    //! \param tile A tile id.
+    //! \return The width and the height in texels.
+    static std::pair<UINT, UINT> GetExtent(const TileId &tile) {
+        auto width = std::max<UINT>(static_cast<UINT>(kDesc.width) >> tile.mip_slice, 1);
+        auto height = std::max<UINT>(kDesc.height >> tile.mip_slice, 1);
+        return {std::min(kTileSize, width - tile.x * kTileSize), std::min(kTileSize, height - tile.y * kTileSize)};
+    }
+
+private:
+    std::mutex _mutex;
+    std::unordered_map<UINT32, UINT> _read_counts;
+    std::unordered_map<UINT32, UINT> _failure_counts;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Retrieve the slot of a tile from the page table.
+//! \param virtual_texture A virtual texture.
+//! \param tile A tile id.
+//! \return A slot or kInvalidTileSlot.
+UINT32 GetSlot(const VirtualTexture &virtual_texture, const TileId &tile) {
+    return virtual_texture.GetPageTable(tile.mip_slice)[tile.y * virtual_texture.GetTileCount(tile.mip_slice).first +
+                                                        tile.x];
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Request tiles every frame until they are resident, and expect that each upload matches the page table.
+//! \param virtual_texture A virtual texture.
+//! \param tiles Tiles to request.
+//! \return Uploads of all frames.
+std::vector<TileUpload> Stream(VirtualTexture &virtual_texture, const std::vector<TileId> &tiles) {
+    std::vector<UINT32> feedback;
+    for (auto &tile : tiles) {
+        feedback.push_back(PackTileId(tile));
+    }
+
+    std::vector<TileUpload> uploads;
+    for (UINT i = 0; i != kMaxUpdateCount; ++i) {
+        virtual_texture.RequestTiles(feedback);
+        for (auto &upload : virtual_texture.Update(kSlotCount)) {
+            Expect(GetSlot(virtual_texture, upload.tile) == upload.slot);
+            Expect(upload.row_pitch == kTileSize * kDesc.element_size && upload.height == kTileSize);
+
+            // Texels outside of a texture are cleared, even if a slot had another tile.
+            auto [width, height] = TileSource::GetExtent(upload.tile);
+            for (UINT y = 0; y != upload.height; ++y) {
+                for (UINT x = 0; x != upload.row_pitch; ++x) {
+                    auto inside = y < height && x < width * kDesc.element_size;
+                    Expect(upload.data[y * upload.row_pitch + x] == (inside ? BuildTexel(upload.tile) : 0));
+                }
+            }
+            uploads.push_back(upload);
+        }
+
+        if (std::all_of(tiles.begin(), tiles.end(), [&virtual_texture](const auto &tile) {
+            return GetSlot(virtual_texture, tile) != kInvalidTileSlot;
+        })) {
+            return uploads;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    Expect(!"Tiles aren't resident.");
+    return uploads;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Expect that the page table maps loaded tiles, the coarsest mip stays resident, resident tiles aren't loaded
+//! again, and the least recently used tile is evicted.
+void ExpectStreaming() {
+    constexpr TileId kCoarsest = {6, 0, 0};
+    constexpr TileId kTiles[] = {{0, 1, 2}, {1, 1, 0}, {3, 0, 0}, {4, 0, 0}};
+
+    TileSource source;
+    VirtualTexture virtual_texture(kDesc, kTileSize, kSlotCount, [&source](auto &tile, auto data, auto row_pitch) {
+        source.Read(tile, data, row_pitch);
+    });
+
+    for (UINT16 mip = 0; mip != kDesc.mip_levels; ++mip) {
+        auto [count_x, count_y] = virtual_texture.GetTileCount(mip);
+        Expect(count_x == std::max(4u >> mip, 1u) && count_y == std::max(4u >> mip, 1u));
+    }
+
+    // The coarsest mip is loaded without requests.
+    auto uploads = Stream(virtual_texture, {kCoarsest});
+    Expect(uploads.size() == 1 && uploads[0].tile.mip_slice == kCoarsest.mip_slice);
+
+    // Tiles are loaded one per frame, so the first is the least recently used.
+    for (auto i = 0; i != 3; ++i) {
+        uploads = Stream(virtual_texture, {kTiles[i]});
+        Expect(uploads.size() == 1 && PackTileId(uploads[0].tile) == PackTileId(kTiles[i]));
+    }
+
+    // Resident tiles and duplicated requests aren't loaded again.
+    Stream(virtual_texture, {kTiles[0], kTiles[0], kTiles[1], kTiles[2], kCoarsest});
+    Expect(source.GetTotalReadCount() == 4);
+
+    // Every slot is full, so the tile which isn't used in this frame is evicted. The coarsest mip is never evicted.
+    auto evicted = GetSlot(virtual_texture, kTiles[0]);
+    uploads = Stream(virtual_texture, {kTiles[1], kTiles[2], kTiles[3]});
+    Expect(uploads.size() == 1 && uploads[0].slot == evicted);
+    Expect(GetSlot(virtual_texture, kTiles[0]) == kInvalidTileSlot);
+    Expect(GetSlot(virtual_texture, kCoarsest) != kInvalidTileSlot);
+
+    // An evicted tile is loaded again on a request.
+    Stream(virtual_texture, {kTiles[0]});
+    Expect(source.GetReadCount(kTiles[0]) == 2);
+    Expect(GetSlot(virtual_texture, kCoarsest) != kInvalidTileSlot);
+    Expect(source.GetReadCount(kCoarsest) == 1);
+
+    // Cleared and out of range entries of a feedback buffer are ignored.
+    const UINT32 feedback[] = {0xFFFFFFFF, PackTileId({0, 4, 0}), PackTileId({7, 0, 0})};
+    virtual_texture.RequestTiles(feedback);
+    Expect(virtual_texture.Update(kSlotCount).empty());
+    Expect(source.GetTotalReadCount() == 6);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Expect that a tile which fails to be read stays unmapped and is loaded again on the next request.
+void ExpectReadFailure() {
+    constexpr TileId kTile = {0, 2, 1};
+
+    TileSource source;
+    source.SetFailureCount(kTile, 1);
+    VirtualTexture virtual_texture(kDesc, kTileSize, kSlotCount, [&source](auto &tile, auto data, auto row_pitch) {
+        source.Read(tile, data, row_pitch);
+    });
+
+    Stream(virtual_texture, {kTile});
+    Expect(source.GetReadCount(kTile) == 2);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+//! Expect that a texture which doesn't fit to a tile id or the tile cache is rejected.
+void ExpectInvalidDesc() {
+    auto reader = [](const TileId &, std::span<BYTE>, UINT64) {};
+
+    auto desc = kDesc;
+    desc.mip_levels = 0;
+    ExpectThrow(VirtualTexture(desc, kTileSize, kSlotCount, reader));
+
+    desc.width = desc.height = 1 << 16;
+    desc.mip_levels = 17;
+    ExpectThrow(VirtualTexture(desc, kTileSize, kSlotCount, reader));
+
+    // 16384 tiles fit to 14 bits, but one more doesn't.
+    desc = kDesc;
+    desc.width = 16384 * kTileSize;
+    desc.height = kTileSize;
+    desc.mip_levels = 15;
+    VirtualTexture(desc, kTileSize, kSlotCount, reader);
+    desc.width += 1;
+    ExpectThrow(VirtualTexture(desc, kTileSize, kSlotCount, reader));
+
+    // A tile of a block compressed format is a multiple of 4x4 blocks.
+    desc = kDesc;
+    ExpectThrow(VirtualTexture(desc, 0, kSlotCount, reader));
+    desc.format = DXGI_FORMAT_BC1_UNORM;
+    desc.element_size = 8;
+    ExpectThrow(VirtualTexture(desc, 6, kSlotCount, reader));
+    VirtualTexture(desc, 8, kSlotCount, reader);
+
+    // The coarsest mip has 2x1 tiles, which are pinned, so another slot is needed to load any other tile.
+    desc = kDesc;
+    desc.width = 128;
+    desc.mip_levels = 1;
+    ExpectThrow(VirtualTexture(desc, 64, 2, reader));
+    VirtualTexture(desc, 64, 3, reader);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int main() {
+    ExpectStreaming();
+    ExpectReadFailure();
+    ExpectInvalidDesc();
+
+    return GetExitCode();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
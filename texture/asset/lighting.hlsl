@@ -34,7 +34,7 @@ Output VSMain(Input input) {
 
     Output output;
     output.sv_position = mul(PVM, position);
-    output.position = mul(model, position).xyz;
+    output.position = mul(view, mul(model, position)).xyz;
     output.uv = input.uv;
     output.normal = mul(normal, input.normal);
     return output;
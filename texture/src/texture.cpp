@@ -7,9 +7,11 @@
 #include <common/example.h>
 #include <common/resource_uploader.h>
 #include <common/image_loader.h>
+#include <algorithm>
 #include <memory>
 #include <vector>
 #include <array>
+#include <stdexcept>
 
 using namespace DirectX;
 
@@ -68,6 +70,26 @@ public:
 
 protected:
     void OnInit() override {
+        // Rebuild a pipeline state when a shader or any file it includes is changed. Files are taken from the last
+        // compile, so an include which is added by an edit is watched after a rebuild.
+        _pipeline_dependent = _hot_reload.Register(_shader_dependencies, [this]() -> HotReload::Swap {
+            std::vector<std::filesystem::path> dependencies;
+            auto pipeline_state = CreatePipelineState(&dependencies);
+            return [this, pipeline_state, dependencies]() {
+                _pipeline_state = pipeline_state;
+                _hot_reload.SetDependencies(_pipeline_dependent, dependencies);
+            };
+        });
+
+        // Recreate a texture when an image is changed.
+        _hot_reload.Register({"metalplate01_rgba.ktx"}, [this]() -> HotReload::Swap {
+            auto texture = CreateTexture();
+            return [this, texture]() {
+                _texture = texture;
+                _device->CreateShaderResourceView(_texture.Get(), nullptr,
+                                                  _descriptor_heaps[D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV]->GetCPUDescriptorHandleForHeapStart());
+            };
+        });
     }
 
     void OnTerm() override {
@@ -96,18 +118,26 @@ protected:
             ImGui::SliderInt("Mip slice", &_options.mip_slice, 0, 9);
         }
 
-        // Define constants.
+        // Define constants. Lighting is done in the view space, so the cached normal matrix of a camera is used.
+        // A model only rotates, so its normal matrix is itself and no inverse is needed.
+        auto view_matrix = _camera.GetView();
+        auto forward = _camera.GetForward();
+        XMFLOAT3 light_position(_options.light_position.data());
+        XMFLOAT3 light_direction(_options.light_direction.data());
+        auto view = XMLoadFloat4x4(&view_matrix);
+        auto model = XMMatrixRotationY(XM_PI);
+
         Constants constants;
         constants.projection = _camera.GetProjection();
-        constants.view = _camera.GetView();
-        XMStoreFloat4x4(&constants.model, XMMatrixRotationY(XM_PI));
-        constants.normal = XMMatrixInverseTranspose(constants.model);
-        constants.view_direction = _camera.GetForward();
+        constants.view = view_matrix;
+        XMStoreFloat4x4(&constants.model, model);
+        XMStoreFloat3x4(&constants.normal, XMMatrixMultiply(model, XMLoadFloat3x4(&_camera.GetViewNormal())));
+        XMStoreFloat3(&constants.view_direction, XMVector3TransformNormal(XMLoadFloat3(&forward), view));
         constants.light_distance = _options.light_distance;
-        constants.light_position = XMFLOAT3(_options.light_position.data());
+        XMStoreFloat3(&constants.light_position, XMVector3TransformCoord(XMLoadFloat3(&light_position), view));
         constants.light_spot_power = _options.light_spot_power;
         constants.light_color = XMFLOAT3(_options.light_color.data());
-        constants.light_direction = XMFLOAT3(_options.light_direction.data());
+        XMStoreFloat3(&constants.light_direction, XMVector3TransformNormal(XMLoadFloat3(&light_direction), view));
         constants.mip_slice = _options.mip_slice;
 
         // Update transformation.
@@ -188,19 +218,10 @@ private:
         ThrowIfFailed(CreateDefaultBuffer(_device.Get(), sizeof(indices), &_index_buffer));
         uploader.RecordCopyData(_index_buffer.Get(), indices, sizeof(indices));
 
-        // Read an image.
-        ImageLoader image_loader;
-        auto image = image_loader.LoadFile("metalplate01_rgba.ktx");
+        uploader.Execute();
 
         // Initialize a texture.
-        ThrowIfFailed(CreateDefaultTexture2D(_device.Get(), image.width, image.height,
-                                             image.mip_levels, image.format, &_texture));
-        for (auto i = 0; i != image.mip_levels; ++i) {
-            auto &subresource = image.subresources[i];
-            uploader.RecordCopyData(_texture.Get(), i, subresource.data, subresource.row_pitch * subresource.height);
-        }
-
-        uploader.Execute();
+        _texture = CreateTexture();
 
         // Initialize constant buffers.
         for (auto i = 0; i != kSwapChainBufferCount; ++i) {
@@ -223,12 +244,6 @@ private:
     }
 
     void InitPipelines() {
-        // Define an input layout.
-        std::vector<D3D12_INPUT_ELEMENT_DESC> input_layout = {
-                {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0,  D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-                {"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT,    0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-                {"NORMAL",   0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 20, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0}};
-
         D3D12_DESCRIPTOR_RANGE descriptor_range = {};
         descriptor_range.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
         descriptor_range.NumDescriptors = 1;
@@ -255,15 +270,60 @@ private:
                                                         D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 
         // Create a root signature.
-        ThrowIfFailed(CreateRootSignature(_device.Get(), &root_signature_desc, &_root_signature));
+        ThrowIfFailed(_pipeline_cache->CreateRootSignature(root_signature_desc, &_root_signature));
+
+        // Create a graphics pipeline state.
+        _pipeline_state = CreatePipelineState(&_shader_dependencies);
+    }
+
+    ComPtr<ID3D12Resource> CreateTexture() {
+        // Read an image.
+        ImageLoader image_loader;
+        auto image = image_loader.LoadFile("metalplate01_rgba.ktx");
+
+        // Create a texture.
+        ComPtr<ID3D12Resource> texture;
+        ThrowIfFailed(CreateDefaultTexture2D(_device.Get(), image.width, image.height,
+                                             image.mip_levels, image.format, &texture));
 
-        // Compile a vertex shader.
-        ComPtr<ID3DBlob> vertex_shader;
-        ThrowIfFailed(CompileShader("lighting.hlsl", "VSMain", "vs_5_0", &vertex_shader));
+        // Upload an image to a texture.
+        ResourceUploader uploader(_device.Get());
+        uploader.RecordCopyData(texture.Get(), image);
+        uploader.Execute();
 
-        // Compile a pixel shader.
-        ComPtr<ID3DBlob> pixel_shader;
-        ThrowIfFailed(CompileShader("lighting.hlsl", "PSMain", "ps_5_0", &pixel_shader));
+        return texture;
+    }
+
+    ComPtr<ID3D12PipelineState> CreatePipelineState(std::vector<std::filesystem::path> *dependencies) {
+        // Define an input layout.
+        std::vector<D3D12_INPUT_ELEMENT_DESC> input_layout = {
+                {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0,  D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+                {"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT,    0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+                {"NORMAL",   0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 20, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0}};
+
+        // Compile a vertex shader and a pixel shader concurrently.
+        std::array<ShaderRequest, 2> requests = {{
+                {"lighting.hlsl", L"VSMain", L"vs_6_0"},
+                {"lighting.hlsl", L"PSMain", L"ps_6_0"}}};
+        auto shaders = _compiler.CompileShaders(requests);
+        for (auto &shader : shaders) {
+            if (FAILED(shader.result)) {
+                throw std::runtime_error(shader.diagnostics);
+            }
+        }
+
+        auto &vertex_shader = shaders[0].code;
+        auto &pixel_shader = shaders[1].code;
+
+        // Collect the sources and includes of shaders.
+        dependencies->clear();
+        for (auto &shader : shaders) {
+            for (auto &dependency : shader.dependencies) {
+                if (std::find(dependencies->begin(), dependencies->end(), dependency) == dependencies->end()) {
+                    dependencies->push_back(dependency);
+                }
+            }
+        }
 
         // Define a graphics pipeline state.
         D3D12_GRAPHICS_PIPELINE_STATE_DESC desc = {};
@@ -283,7 +343,10 @@ private:
         desc.SampleDesc = {1, 0};
 
         // Create a graphics pipeline state.
-        ThrowIfFailed(_device->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(&_pipeline_state)));
+        ComPtr<ID3D12PipelineState> pipeline_state;
+        ThrowIfFailed(_pipeline_cache->CreateGraphicsPipelineState(desc, &pipeline_state));
+
+        return pipeline_state;
     }
 
 private:
@@ -296,6 +359,8 @@ private:
     D3D12_INDEX_BUFFER_VIEW _index_buffer_view = {};
     ComPtr<ID3D12RootSignature> _root_signature;
     ComPtr<ID3D12PipelineState> _pipeline_state;
+    std::vector<std::filesystem::path> _shader_dependencies;
+    UINT _pipeline_dependent = 0;
     D3D12_VIEWPORT _viewport = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f};
     D3D12_RECT _scissor_rect = {0, 0, 0, 0};
 };
@@ -6,7 +6,11 @@
 #include <common/window.h>
 #include <common/example.h>
 #include <common/resource_uploader.h>
+#include <common/shader_reflection.h>
+#include <algorithm>
 #include <memory>
+#include <array>
+#include <stdexcept>
 
 using namespace DirectX;
 
@@ -75,13 +79,12 @@ protected:
         }
 
         // Define transformation.
-        Transformations transformation;
-        transformation.projection = _camera.GetProjection();
-        transformation.view = _camera.GetView();
-        transformation.model = kIdentityFloat4x4;
+        _transformations.projection = _camera.GetProjection();
+        _transformations.view = _camera.GetView();
+        _transformations.model = kIdentityFloat4x4;
 
-        // Update transformation.
-        UpdateBuffer(_constant_buffers[index].Get(), &transformation, sizeof(Transformations));
+        // Update transformation. A copy is kept, because root constants are recorded on a command list.
+        UpdateBuffer(_constant_buffers[index].Get(), &_transformations, sizeof(Transformations));
     }
 
     void OnRender(UINT index) override {
@@ -110,7 +113,16 @@ protected:
         _command_list->RSSetViewports(1, &_viewport);
         _command_list->RSSetScissorRects(1, &_scissor_rect);
         _command_list->SetGraphicsRootSignature(_root_signature.Get());
-        _command_list->SetGraphicsRootConstantBufferView(0, _constant_buffers[index]->GetGPUVirtualAddress());
+        switch (_transformations_type) {
+            case D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS:
+                _command_list->SetGraphicsRoot32BitConstants(_transformations_parameter, _transformations_size,
+                                                             &_transformations, 0);
+                break;
+            default:
+                _command_list->SetGraphicsRootConstantBufferView(_transformations_parameter,
+                                                                 _constant_buffers[index]->GetGPUVirtualAddress());
+                break;
+        }
         _command_list->SetPipelineState(_pipeline_state.Get());
         _command_list->IASetVertexBuffers(0, 1, &_vertex_buffer_view);
         _command_list->IASetIndexBuffer(&_index_buffer_view);
@@ -177,33 +189,58 @@ private:
     }
 
     void InitPipelines() {
-        // Define an input layout.
-        std::vector<D3D12_INPUT_ELEMENT_DESC> input_layout = {
-                {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0,  D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-                {"COLOR",    0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0}};
+        // Compile a vertex shader and a pixel shader concurrently.
+        std::array<ShaderRequest, 2> requests = {{
+                {"pass_through.hlsl", L"VSMain", L"vs_6_0"},
+                {"pass_through.hlsl", L"PSMain", L"ps_6_0"}}};
+        auto shaders = _compiler.CompileShaders(requests);
+        for (auto &shader : shaders) {
+            if (FAILED(shader.result)) {
+                throw std::runtime_error(shader.diagnostics);
+            }
+        }
+
+        auto &vertex_shader = shaders[0].code;
+        auto &pixel_shader = shaders[1].code;
+
+        // Reflect a vertex shader and a pixel shader.
+        ComPtr<ID3D12ShaderReflection> vertex_reflection;
+        ThrowIfFailed(_compiler.ReflectShader(vertex_shader.Get(), &vertex_reflection));
 
-        // Define a root parameter.
-        CD3DX12_ROOT_PARAMETER root_parameter;
-        root_parameter.InitAsConstantBufferView(0);
+        ComPtr<ID3D12ShaderReflection> pixel_reflection;
+        ThrowIfFailed(_compiler.ReflectShader(pixel_shader.Get(), &pixel_reflection));
 
-        // Define a root signature.
-        CD3DX12_ROOT_SIGNATURE_DESC root_signature_desc(1, &root_parameter, 0, nullptr,
-                                                        D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
+        // Generate an input layout and a root signature from reflections.
+        InputLayout input_layout(vertex_reflection.Get());
+        std::array<ID3D12ShaderReflection *, 2> reflections = {vertex_reflection.Get(), pixel_reflection.Get()};
+        RootSignatureLayout root_signature_layout(reflections);
 
         // Create a root signature.
-        ThrowIfFailed(CreateRootSignature(_device.Get(), &root_signature_desc, &_root_signature));
+        ThrowIfFailed(_pipeline_cache->CreateRootSignature(root_signature_layout.GetDesc(), &_root_signature));
 
-        // Compile a vertex shader.
-        ComPtr<IDxcBlob> vertex_shader;
-        ThrowIfFailed(_compiler.CompileShader("pass_through.hlsl", L"VSMain", L"vs_6_0", &vertex_shader));
+        // Find where transformations are bound. A small constant buffer becomes root constants, and a root
+        // signature has no descriptor table for a constant buffer here.
+        auto binding = root_signature_layout.FindBinding("Transformations");
+        if (!binding) {
+            throw std::runtime_error("Fail to find a binding of Transformations.");
+        }
+
+        auto &parameter = root_signature_layout.GetDesc().pParameters[binding->parameter_index];
+        if (parameter.ParameterType != D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS &&
+            parameter.ParameterType != D3D12_ROOT_PARAMETER_TYPE_CBV) {
+            throw std::runtime_error("Fail to bind Transformations: unsupported root parameter type.");
+        }
 
-        // Compile a pixel shader.
-        ComPtr<IDxcBlob> pixel_shader;
-        ThrowIfFailed(_compiler.CompileShader("pass_through.hlsl", L"PSMain", L"ps_6_0", &pixel_shader));
+        _transformations_parameter = binding->parameter_index;
+        _transformations_type = parameter.ParameterType;
+        if (parameter.ParameterType == D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS) {
+            // A constant buffer in shaders can be smaller than a structure, which is padded to whole registers.
+            _transformations_size = std::min<UINT>(parameter.Constants.Num32BitValues, sizeof(Transformations) / 4);
+        }
 
         // Define a graphics pipeline state.
         D3D12_GRAPHICS_PIPELINE_STATE_DESC desc = {};
-        desc.InputLayout = {input_layout.data(), static_cast<UINT>(input_layout.size())};
+        desc.InputLayout = input_layout.GetDesc();
         desc.pRootSignature = _root_signature.Get();
         desc.VS = {reinterpret_cast<BYTE *>(vertex_shader->GetBufferPointer()), vertex_shader->GetBufferSize()};
         desc.PS = {reinterpret_cast<BYTE *>(pixel_shader->GetBufferPointer()), pixel_shader->GetBufferSize()};
@@ -219,7 +256,7 @@ private:
         desc.SampleDesc = {1, 0};
 
         // Create a graphics pipeline state.
-        ThrowIfFailed(_device->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(&_pipeline_state)));
+        ThrowIfFailed(_pipeline_cache->CreateGraphicsPipelineState(desc, &_pipeline_state));
     }
 
 private:
@@ -227,6 +264,10 @@ private:
     ComPtr<ID3D12Resource> _vertex_buffer;
     ComPtr<ID3D12Resource> _index_buffer;
     FrameResource<ID3D12Resource> _constant_buffers;
+    Transformations _transformations = {};
+    UINT _transformations_parameter = 0;
+    D3D12_ROOT_PARAMETER_TYPE _transformations_type = D3D12_ROOT_PARAMETER_TYPE_CBV;
+    UINT _transformations_size = 0;
     D3D12_VERTEX_BUFFER_VIEW _vertex_buffer_view = {};
     D3D12_INDEX_BUFFER_VIEW _index_buffer_view = {};
     ComPtr<ID3D12RootSignature> _root_signature;